@@ -2,288 +2,627 @@
 // petersen n k
 // grid h w
 // file filename
+// sweep family a b [presets]   solve every graph of a family, where family is petersen, grid, ladder or subdiv with the
+//                              parameters of createGPetersenAdjs, createGridAdjs, createLadderTwistAdjs or createSubdivG1Adjs,
+//                              a and b are a value or an inclusive range like 5:20, and presets are any of a, i, o (default a;
+//                              i and o only for petersen and ladder). instances run as separate processes, -t at a time and
+//                              largest first, and each prints one CSV line (or JSON with -j) as soon as it is solved
+//
+// flags, which can go anywhere on the command line:
+// -m megabytes   cap the memory of the nimber table, replacing entries once it is full
+// -l             solve layer by layer (retrograde) instead of with a depth first search
+// -t threads     number of threads to search with, by default 1. with more than one thread the depth first search
+//                runs in parallel, and the nimber table is allocated at its full size (1024 megabytes unless -m is given)
+// -r             split positions into independent regions and solve those separately, in the single threaded depth first search,
+//                so it cannot be combined with -t above 1 except in a sweep
+// -j             print sweep results as JSON lines instead of CSV
+// -c directory   keep the nimber table of each graph in a cache file in directory, named by the graph's fingerprint, so that
+//                later runs on the same graph reuse its nimbers. with -t the file is as large as the whole table, so give -m
+//                to bound it. not used by -l
+// -d             compute the nimber of every position of the graph (at most 32 vertices) bottom-up by number of 1's, with -t
+//                threads, print how the nimbers and P-positions are spread over the layers, and answer from that table
+// -q file        solve every start state in file (- for standard input) on the graph, one bit string or preset a/i/o per
+//                line, and print their nimbers one per line in the same order. the start state argument is ignored
+// --stats        count the work of the depth first search, per thread and per layer (number of 1's), and print a summary to
+//                standard error once the graph is solved: expanded positions, nimber table hit rate, average branching factor,
+//                maximum depth and table size. not used by -l or -d
+// --progress s   print a progress line to standard error about every s seconds of a depth first search
+// --outcome      only decide whether the start state is a P-position (a win for the second player) or an N-position, which
+//                stops at the first P-position among the children of a position instead of solving all of them. single threaded,
+//                and printed as P or N in place of the nimber. outcomes take a full nimber table entry each, so this saves
+//                positions searched but not memory per position
+// --checkpoint file   write the solved positions of a depth first search to file every 10 minutes, and when the process gets
+//                SIGINT or SIGTERM, which then stops it. not needed with -c, whose cache file already keeps every nimber
+// --checkpoint-every s   write the checkpoint every s seconds instead
+// --resume       start from the checkpoint file of --checkpoint, skipping every position it has already solved
 //
 
 // code compiled with gcc 10.3, may not be backwards compatible with older versions of c++
-#include <fstream>
-#include <vector>
-#include <unordered_set>
-#include <unordered_map>
-#include <string>
-#include <cctype>
-#include <algorithm>
-#include <iostream>
-using namespace std;
-
-vector<unordered_set<int>> adjMatrix;
-unordered_map<string, int> nimberComps;
-
-// createAdjs(n, inLines) creates the graph from the adjacency matrix, where inLines is a list of binary strings corresponding to each vertex in order and n is the number of vertices. This will wipe adjMatrix and fill it with the adjacencies in this graph.
-void createAdjs(int n, vector<string> inLines)
+#include "toggle.h"
+#include <chrono>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <csignal>
+
+// readGraphLines(filename) reads the lines of the graph from the file and stores them in the global variable adjMatrix, and returns the value of n, which is the number of vertices in the graph
+int readGraphLines(string filename)
 {
-  // adjMatrix = {}
-  for (int i = 0; i < n; i++)
+  int n = -1;              // default value if there is no file to read
+  vector<string> adjLines; // list of the adjacencies for each vtx, represented as strings, if reading from file
+
+  ifstream graphfile;
+  graphfile.open(filename);
+  if (graphfile.is_open())
   {
-    unordered_set<int> iAdjs;
-    for (int j = 0; j < n; j++)
+    // read the size from the file
+    string size;
+    getline(graphfile, size);
+    n = stoi(size);
+    // read each of the n successive lines from the file
+    // precondition -- there are n lines of binary strings after the first
+    string adjLine;
+    while (getline(graphfile, adjLine))
     {
-      if (inLines[i][j] == '1')
-      {
-        iAdjs.insert(j);
-      }
+      adjLines.push_back(adjLine);
     }
-    adjMatrix.push_back(iAdjs);
+    graphfile.close();
+
+    // create graph matrix from file input
+    createAdjs(n, adjLines);
   }
+  else
+  {
+    cout << "file not found, please check to see if you have the right file \n";
+  }
+
+  return n;
+}
+
+// initializeState(n, argc, argPos, argv[]) by default will always return a string of n 1's. if there are enough command line arguments, instead return the next command line argument which will be a bit string of length n, with 1s and 0s assigned to the vertices as given in the adjacency matrix or with the right conventions for the Petersen graph/grid.
+// presetState(n, preset) returns the start state of a preset for a graph whose vertices are an outer half and an inner half: a is all 1's, i is 1's inside and o is 1's outside
+string presetState(int n, char preset)
+{
+  int k = n / 2;
+  if (preset == 'i')
+    return string(k, '0') + string(k, '1');
+  if (preset == 'o')
+    return string(k, '1') + string(k, '0');
+  return string(n, '1');
 }
 
-// createGPetersenAdjs(n, k) will wipe adjMatrix, create the adjacencies for the generalized Petersen graph GP(n, k) and store them in adjMatrix.
-void createGPetersenAdjs(int n, int k)
+string initializeState(int n, int argc, int argPos, char *argv[])
 {
-  adjMatrix = vector<unordered_set<int>>();
-  for (int j = 0; j < 2 * n; j++)
+  string startState = string(n, '1');
+  if (argPos < argc)
   {
-    if (j < n)
+    if (*argv[1] == 'p')
     {
-      adjMatrix.push_back(unordered_set<int>({(j + n - 1) % n, (j + 1) % n, j + n}));
+      // n is guaranteed to be even if we have petersen
+      if (*argv[argPos] == 'i' || *argv[argPos] == 'o')
+      {
+        startState = presetState(n, *argv[argPos]);
+      }
+      else if (*argv[argPos] != 'a')
+      {
+        startState = argv[argPos];
+      }
+      // otherwise, don't do anything, should be all 1's
     }
     else
     {
-      adjMatrix.push_back(unordered_set<int>({j - n, (j + n - k) % n + n, (j + k) % n + n}));
+      startState = argv[argPos];
     }
   }
-  return;
+  startState.resize(n, '0'); // a bit string of the wrong length is cut or padded with 0's to the graph
+  return startState;
 }
 
-// createGridAdjs(h, w) will wipe adjMatrix, create the adjacencies for an h x w grid and store them in adjMatrix.
-void createGridAdjs(int h, int w)
+// tableMegabytes is the memory cap of the nimber table in megabytes, set with -m, where 0 means no cap
+uint64_t tableMegabytes = 0;
+// PARALLEL_TABLE_MEGABYTES is the size of the nimber table for a parallel search when -m is not given
+const uint64_t PARALLEL_TABLE_MEGABYTES = 1024;
+// layered is set by -l to use runGameLayered in place of runGame
+bool layered = false;
+// dense is set by -d to answer from denseTable, which holds the nimber of every position
+bool dense = false;
+DenseTable denseTable;
+// sweepWorker is set in the processes of a sweep, which only print their result line
+bool sweepWorker = false;
+// jsonLines is set by -j to print sweep results as JSON lines
+bool jsonLines = false;
+// cacheDirectory is the directory of the cache files, set with -c, or empty for no cache
+string cacheDirectory;
+// queryFile is the file of start states to solve, set with -q, where - is standard input, or empty to solve the one start state on the command line
+string queryFile;
+// outcomeOnly is set by --outcome to use runOutcome in place of the nimber engines
+bool outcomeOnly = false;
+// showStats is set by --stats to collect searchStats and print them once the graph is solved
+bool showStats = false;
+// progressSeconds is the interval of the progress lines set with --progress, or 0 for none
+int progressSeconds = 0;
+// checkpointFile is the checkpoint file set with --checkpoint, or empty for none, and checkpointSeconds the interval set with --checkpoint-every
+string checkpointFile;
+int checkpointSeconds = 600;
+// resume is set by --resume to load checkpointFile before solving
+bool resume = false;
+// stopRequested is set by SIGINT and SIGTERM while checkpointing, and the search stops at its next searchHook call
+volatile sig_atomic_t stopRequested = 0;
+// searchRoot is the start state being solved, and resumedSeconds the search time recorded in the checkpoint it resumed from
+State searchRoot;
+double resumedSeconds = 0;
+// CACHE_SYNC_SECONDS is how often a long search writes its cache file back to disk
+const int CACHE_SYNC_SECONDS = 60;
+// threadCount is the number of threads for the parallel engines, set with -t
+int threadCount = 1;
+
+// parseFlags(argc, argv) reads the flags, which start with '-', and removes them from argv so that the other options keep their positions. returns the new argc.
+int parseFlags(int argc, char *argv[])
 {
-  adjMatrix = vector<unordered_set<int>>();
-  for (int k = 0; k < h * w; k++)
+  int kept = 1;
+  for (int i = 1; i < argc; i++)
   {
-    unordered_set<int> adjs = unordered_set<int>();
-    // r is the row of position k, indexed from 0
-    int r = k / w;
-    // c is the column of position k, indexed from 0
-    int c = k % w;
-
-    if (r != 0)
-      adjs.insert(k - w);
-    if (r < h - 1)
-      adjs.insert(k + w);
-    if (c != 0)
-      adjs.insert(k - 1);
-    if (c < w - 1)
-      adjs.insert(k + 1);
-
-    adjMatrix.push_back(adjs);
+    string flag = argv[i];
+    if (flag.size() < 2 || flag[0] != '-')
+    {
+      argv[kept++] = argv[i];
+    }
+    else if (flag == "-m" && i + 1 < argc)
+    {
+      tableMegabytes = stoull(argv[++i]);
+    }
+    else if (flag == "-l")
+    {
+      layered = true;
+    }
+    else if (flag == "-d")
+    {
+      dense = true;
+    }
+    else if (flag == "-r")
+    {
+      splitRegions = true;
+    }
+    else if (flag == "-j")
+    {
+      jsonLines = true;
+    }
+    else if (flag == "-c" && i + 1 < argc)
+    {
+      cacheDirectory = argv[++i];
+    }
+    else if (flag == "-q" && i + 1 < argc)
+    {
+      queryFile = argv[++i];
+    }
+    else if (flag == "--outcome")
+    {
+      outcomeOnly = true;
+    }
+    else if (flag == "--stats")
+    {
+      showStats = true;
+      collectStats = true;
+    }
+    else if (flag == "--progress" && i + 1 < argc)
+    {
+      progressSeconds = max(1, stoi(argv[++i]));
+    }
+    else if (flag == "--checkpoint" && i + 1 < argc)
+    {
+      checkpointFile = argv[++i];
+    }
+    else if (flag == "--checkpoint-every" && i + 1 < argc)
+    {
+      checkpointSeconds = max(1, stoi(argv[++i]));
+    }
+    else if (flag == "--resume")
+    {
+      resume = true;
+    }
+    else if (flag == "-t" && i + 1 < argc)
+    {
+      threadCount = max(1, stoi(argv[++i]));
+    }
+    else
+    {
+      cout << "unknown flag " << flag << "\n";
+      exit(1);
+    }
   }
-  return;
+  return kept;
+}
+
+// searchStart is when openCache set up the current search, and lastSync, lastProgress and lastCheckpoint when watchSearch last synced the cache file, printed progress and wrote a checkpoint
+chrono::steady_clock::time_point searchStart, lastSync, lastProgress, lastCheckpoint;
+
+// requestStop(signal) is the handler of SIGINT and SIGTERM while checkpointing
+void requestStop(int)
+{
+  stopRequested = 1;
 }
 
-// printSet prints theSet within curly braces, separated by commas
-void printSet(unordered_set<string> theSet)
+// searchTable() returns the table the search chosen by the flags fills, outcomeComps with --outcome and nimberComps otherwise
+NimTable &searchTable()
 {
-  cout << "{";
-  for (unordered_set<string>::iterator it = theSet.begin(); it != theSet.end(); ++it)
-  {
-    cout << *it << ", ";
-  }
-  cout << "}\n";
+  return outcomeOnly ? outcomeComps : nimberComps;
+}
+
+// parallelSearch() decides whether the search chosen by the flags is runGameParallel
+bool parallelSearch()
+{
+  return threadCount > 1 && !layered && !dense && !outcomeOnly;
+}
+
+// resultText(value) formats a value returned by solve: an outcome with --outcome, else a nimber
+string resultText(int value)
+{
+  if (outcomeOnly)
+    return value == P_POSITION ? "P" : "N";
+  return to_string(value);
+}
+
+// checkpoint() writes checkpointFile for the current search
+void checkpoint()
+{
+  double seconds = resumedSeconds + chrono::duration<double>(chrono::steady_clock::now() - searchStart).count();
+  if (!writeCheckpoint(searchTable(), checkpointFile, graphFingerprint(), searchRoot, seconds, outcomeOnly))
+    cerr << "could not write the checkpoint file " << checkpointFile << "\n";
 }
 
-// toggle(gameState, place, n) toggles the state of place and all of its neighbors.
-// precondition: place must be between 0 and n - 1 inclusive, and the gameState has all 0s and 1s.
-string toggle(string gameState, int place, int n)
+// watchSearch(progress) is the searchHook of a search with a cache file, progress lines or checkpoints. it writes the cache file back every CACHE_SYNC_SECONDS, prints a progress line every progressSeconds and writes a checkpoint every checkpointSeconds.
+// once SIGINT or SIGTERM arrives it writes a last checkpoint and stops the search.
+bool watchSearch(const SearchProgress &progress)
 {
-  unordered_set<int> adj = adjMatrix.at(place);
-  char nextState[n];
-  for (int i = 0; i < n; i++)
+  auto now = chrono::steady_clock::now();
+  if (!checkpointFile.empty() && (stopRequested || now - lastCheckpoint >= chrono::seconds(checkpointSeconds)))
   {
-    if (adj.count(i) == 1 || i == place)
-    {
-      nextState[i] = 1 - (gameState[i] - '0') + '0';
-    }
-    else
-    {
-      nextState[i] = gameState[i];
-    }
+    checkpoint();
+    lastCheckpoint = now;
+    if (stopRequested)
+      return false;
+  }
+  if (nimberComps.fd >= 0 && now - lastSync > chrono::seconds(CACHE_SYNC_SECONDS))
+  {
+    syncTableFile(nimberComps, false);
+    lastSync = now;
   }
-  return nextState;
+  if (progressSeconds > 0 && now - lastProgress >= chrono::seconds(progressSeconds))
+  {
+    double seconds = chrono::duration<double>(now - searchStart).count();
+    cerr << "progress: " << (int)seconds << "s, expanded " << progress.expanded << " positions (" << (uint64_t)(progress.expanded / seconds)
+         << "/s), depth " << progress.depth << ", table " << __atomic_load_n(&searchTable().used, __ATOMIC_RELAXED) << " entries" << endl;
+    lastProgress = now;
+  }
+  return true;
 }
 
-// getNextStates(n, gameState) finds all valid next states that the game can progress to from the current state, gameState. n is the number of vertices in the graph.
-// RULE: the number of 1's must STRICTLY decrease, and we can only toggle 1's.
-unordered_set<string> getNextStates(int n, string gameState)
+// openCache() moves nimberComps into the cache file of the current graph if -c was given, and sizes it for the parallel search.
+// with -d it fills denseTable instead and prints its layers.
+void openCache()
 {
-  unordered_set<string> nextStates;
-  for (int i = 0; i < n; i++)
+  if (dense)
+  {
+    if (denseTable.vertices != numVertices || denseTable.nibbles.empty())
+      solveDense(denseTable, threadCount);
+    if (!sweepWorker)
+      printDenseLayers(denseTable);
+    return;
+  }
+  if (!cacheDirectory.empty() && !layered)
+  {
+    char name[32];
+    snprintf(name, sizeof(name), "/%016llx.nim", (unsigned long long)graphFingerprint());
+    openTableFile(nimberComps, cacheDirectory + name, graphFingerprint());
+  }
+  if (parallelSearch())
+    presizeTable(nimberComps);
+  if (!checkpointFile.empty() && nimberComps.fd >= 0)
   {
-    if (gameState[i] == '1')
+    cerr << "the cache file keeps every nimber already, so --checkpoint is not used with -c\n";
+    checkpointFile.clear();
+  }
+  if (!checkpointFile.empty() && !layered)
+  {
+    signal(SIGINT, requestStop);
+    signal(SIGTERM, requestStop);
+    if (resume)
     {
-      int onCounter = 0;
-      unordered_set<int> adjSet = adjMatrix[i];
-      // count number of neighbors that are on
-      for (unordered_set<int>::iterator it = adjSet.begin(); it != adjSet.end(); ++it)
-      {
-        if (gameState[*it] == '1')
-        {
-          onCounter++;
-        }
-      }
-      // len(adjMatrix[i]) - onCounter is number of off neighbors
-      // want 1 + onCounter > len(adjMatrix[i]) - onCounter (if it's 1)
-      // want onCounter > len(adjMatrix[i]) - onCounter + 1 (if it's 0)
-      // check if the move is valid, and if so, compute the next state and add it to list
-      if ((gameState[i] - '0') + 2 * onCounter > adjSet.size() + (1 - (gameState[i] - '0')))
-        nextStates.insert(toggle(gameState, i, n));
+      State root;
+      int64_t entries = readCheckpoint(searchTable(), checkpointFile, graphFingerprint(), root, resumedSeconds, outcomeOnly);
+      if (entries < 0)
+        cerr << "no checkpoint of this graph in " << checkpointFile << ", starting from scratch\n";
+      else
+        cerr << "resuming from " << entries << " positions solved in " << (int)resumedSeconds << "s\n";
     }
   }
-  return nextStates;
+  if ((nimberComps.fd >= 0 || progressSeconds > 0 || !checkpointFile.empty()) && !layered)
+    searchHook = watchSearch;
+  searchStart = lastSync = lastProgress = lastCheckpoint = chrono::steady_clock::now();
 }
 
-// mex(natSet) computes the minimum excluded natural number of a set of integers
-int mex(unordered_set<int> natSet)
+// solveState(startState) computes the nimber of startState with the engine chosen by the flags
+// a search stopped by a signal exits the program once its checkpoint is written.
+int solveState(const State &startState)
 {
-  int currMex = 0;
-  while (natSet.count(currMex) == 1)
+  if (dense)
+    return denseNimber(denseTable, denseIndex(startState));
+  if (layered && !outcomeOnly)
+    return runGameLayered(startState, threadCount);
+  searchRoot = startState;
+  int nimVal = outcomeOnly ? runOutcome(startState) : parallelSearch() ? runGameParallel(startState, threadCount) : runGame(startState);
+  if (nimVal < 0)
   {
-    currMex++;
+    cerr << "stopped, the solved positions are in " << checkpointFile << ", run again with --resume to continue\n";
+    exit(1);
   }
-  return currMex;
+  return nimVal;
 }
 
-// rotate(state, n) rotates a state for GP(n, _) by one vertex counterclockwise, where n is the length of the outer/inner cycles
-string rotate(string state, int n)
+// closeCache() prints the search statistics if --stats was given and closes the graph's cache file if there is one
+void closeCache()
 {
-  return state.substr(1, n - 1) + state.substr(0, 1) + state.substr(n + 1, n - 1) + state.substr(n, 1);
+  if (showStats && !layered && !dense && !sweepWorker)
+    printSearchStats(cerr, searchTable());
+  closeTableFile(nimberComps);
 }
 
-// runGame(startState, n) recursively computes the nimber of gameState by traversing through the whole subtree from that point, memoizing game states it has already seen.
-int runGame(string startState, int n)
+// solve(startState) computes the nimber of startState with the engine chosen by the flags, in the graph's cache file if there is one
+int solve(const State &startState)
 {
-  unordered_set<string> nextStates = getNextStates(n, startState);
-
-  // debug
-  // cout << startState << ": ";
-  // printSet(nextStates);
-
-  if (nextStates.size() == 0)
-  {
-    nimberComps.emplace(startState, 0);
-    return 0;
-  }
+  openCache();
+  int nimVal = solveState(startState);
+  closeCache();
+  return nimVal;
+}
 
-  else
+// solveQueries(n) solves every start state listed in queryFile on the current graph with n vertices and prints their nimbers, one per line in the order of the file.
+// a line is a bit string like the start state argument, or a, i or o for the presets of presetState; empty lines and lines starting with # are skipped.
+// all queries share one nimber table, and the states with the most 1's go first, since their searches pass through most of the positions of the smaller ones.
+void solveQueries(int n)
+{
+  ifstream file;
+  if (queryFile != "-")
   {
-    unordered_set<int> childNimbers;
-    for (unordered_set<string>::iterator s = nextStates.begin(); s != nextStates.end(); ++s)
+    file.open(queryFile);
+    if (!file.is_open())
     {
-      // also check if cyclic permutations are present
-      // cycle through currRotState and check if each one is in nimberComps
-      // if we get a match then we should return that as the nimber
-      string currRotState = *s;
-      bool matchFound = false;
-      for (int k = 0; k < n; k++)
-      {
-        if (nimberComps.count(currRotState) == 1)
-        {
-          childNimbers.insert(nimberComps[currRotState]);
-          matchFound = true;
-          break;
-        }
-        // n is the number of vertices here
-        currRotState = rotate(currRotState, n / 2);
-      }
-
-      if (!matchFound)
-      {
-        int gameNimVal = runGame(*s, n);
-        nimberComps.emplace(*s, gameNimVal);
-        childNimbers.insert(gameNimVal);
-      }
+      cout << "query file not found, please check to see if you have the right file \n";
+      return;
     }
-    int stateNimber = mex(childNimbers);
+  }
+  istream &in = queryFile == "-" ? cin : file;
+  vector<State> queries;
+  string line;
+  while (getline(in, line))
+  {
+    line.erase(remove_if(line.begin(), line.end(), [](char c)
+                         { return isspace((unsigned char)c); }),
+               line.end());
+    if (line.empty() || line[0] == '#')
+      continue;
+    if (line == "a" || line == "i" || line == "o")
+      line = presetState(n, line[0]);
+    line.resize(n, '0');
+    queries.push_back(stateFromString(line));
+  }
 
-    // debug
-    // cout << startState << ": " << stateNimber << "\n";
+  vector<int> order(queries.size());
+  for (int i = 0; i < (int)order.size(); i++)
+    order[i] = i;
+  stable_sort(order.begin(), order.end(), [&](int x, int y)
+              { return popcount(queries[x]) > popcount(queries[y]); });
+  vector<int> nimbers(queries.size());
+  openCache();
+  for (int i = 0; i < (int)order.size(); i++)
+    nimbers[order[i]] = solveState(queries[order[i]]);
+  closeCache();
+  for (int i = 0; i < (int)nimbers.size(); i++)
+    cout << resultText(nimbers[i]) << "\n";
+}
 
-    return stateNimber;
+// SweepInstance is one graph of a sweep with its start state preset
+struct SweepInstance
+{
+  char family; // first letter of the family name
+  int a, b;    // parameters of the family builder
+  char preset; // a, i or o, see presetState
+  int vertices;
+};
+
+// familyName(family) returns the name of a sweep family from its first letter
+string familyName(char family)
+{
+  switch (family)
+  {
+  case 'p':
+    return "petersen";
+  case 'g':
+    return "grid";
+  case 'l':
+    return "ladder";
+  default:
+    return "subdiv";
   }
 }
 
-// readGraphLines(filename) reads the lines of the graph from the file and stores them in the global variable adjMatrix, and returns the value of n, which is the number of vertices in the graph
-int readGraphLines(string filename)
+// familyVertices(family, a, b) returns the number of vertices of the graph of a family with parameters a and b
+int familyVertices(char family, int a, int b)
 {
-  int n = -1;              // default value if there is no file to read
-  vector<string> adjLines; // list of the adjacencies for each vtx, represented as strings, if reading from file
-
-  ifstream graphfile;
-  graphfile.open(filename);
-  if (graphfile.is_open())
+  switch (family)
   {
-    // read the size from the file
-    string size;
-    getline(graphfile, size);
-    n = stoi(size);
-    // read each of the n successive lines from the file
-    // precondition -- there are n lines of binary strings after the first
-    string adjLine;
-    while (getline(graphfile, adjLine))
-    {
-      adjLines.push_back(adjLine);
-    }
-    graphfile.close();
-
-    // create graph matrix from file input
-    createAdjs(n, adjLines);
+  case 'p':
+  case 'l':
+    return 2 * a;
+  case 'g':
+    return a * b;
+  default:
+    return a * b + a;
   }
-  else
+}
+
+// buildFamily(family, a, b) creates the graph of a family with parameters a and b
+void buildFamily(char family, int a, int b)
+{
+  switch (family)
   {
-    cout << "file not found, please check to see if you have the right file \n";
+  case 'p':
+    createGPetersenAdjs(a, b);
+    break;
+  case 'g':
+    createGridAdjs(a, b);
+    break;
+  case 'l':
+    createLadderTwistAdjs(a, b);
+    break;
+  default:
+    createSubdivG1Adjs(a, b);
+    break;
   }
+}
 
-  return n;
+// parseRange(arg, lo, hi) reads a sweep parameter, either a single value or an inclusive range lo:hi
+void parseRange(const string &arg, int &lo, int &hi)
+{
+  size_t colon = arg.find(':');
+  lo = stoi(arg.substr(0, colon));
+  hi = colon == string::npos ? lo : stoi(arg.substr(colon + 1));
 }
 
-// initializeState(n, argc, argPos, argv[]) by default will always return a string of n 1's. if there are enough command line arguments, instead return the next command line argument which will be a bit string of length n, with 1s and 0s assigned to the vertices as given in the adjacency matrix or with the right conventions for the Petersen graph/grid.
-string initializeState(int n, int argc, int argPos, char *argv[])
+// solveInstance(instance) builds and solves one sweep instance from a fresh table and returns its result line
+string solveInstance(const SweepInstance &instance)
 {
-  string startState = string(n, '1');
-  if (argPos < argc)
+  initTable(nimberComps, tableMegabytes << 20);
+  initTable(outcomeComps, tableMegabytes << 20);
+  buildFamily(instance.family, instance.a, instance.b);
+  State startState = stateFromString(presetState(instance.vertices, instance.preset));
+  auto start = chrono::steady_clock::now();
+  int nimVal = solve(startState);
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  string family = familyName(instance.family);
+  string a = to_string(instance.a), b = to_string(instance.b), preset(1, instance.preset);
+  string vertices = to_string(instance.vertices), nimber = resultText(nimVal), memo = to_string(searchTable().used);
+  char time[32];
+  snprintf(time, sizeof(time), "%.6f", seconds);
+  if (jsonLines)
+    return "{\"family\":\"" + family + "\",\"a\":" + a + ",\"b\":" + b + ",\"preset\":\"" + preset + "\",\"vertices\":" + vertices +
+           (outcomeOnly ? ",\"outcome\":\"" + nimber + "\"" : ",\"nimber\":" + nimber) + ",\"seconds\":" + time + ",\"memo\":" + memo + "}\n";
+  return family + "," + a + "," + b + "," + preset + "," + vertices + "," + nimber + "," + time + "," + memo + "\n";
+}
+
+// runSweep(instances, workers) solves every instance in its own process, at most workers at a time and the largest graphs first, so the longest runs do not end up last.
+// a process per instance keeps the global graph and nimber table of each instance separate. results are printed in the order they finish.
+void runSweep(vector<SweepInstance> instances, int workers)
+{
+  stable_sort(instances.begin(), instances.end(), [](const SweepInstance &x, const SweepInstance &y)
+              { return x.vertices > y.vertices; });
+  if (!jsonLines)
+    cout << "family,a,b,preset,vertices," << (outcomeOnly ? "outcome" : "nimber") << ",seconds,memo" << endl;
+
+  unordered_map<pid_t, int> running; // process of each running instance, to the read end of its pipe
+  size_t next = 0;
+  while (next < instances.size() || !running.empty())
   {
-    if (*argv[1] == 'p')
+    if (next < instances.size() && (int)running.size() < workers)
     {
-      int k = n / 2; // guaranteed to be even if we have petersen
-      if (*argv[argPos] == 'i')
+      int fds[2];
+      if (pipe(fds) != 0)
       {
-        startState = string(k, '0') + string(k, '1');
+        cout << "could not create a pipe for the sweep\n";
+        exit(1);
       }
-      else if (*argv[argPos] == 'o')
+      cout.flush();
+      pid_t pid = fork();
+      if (pid == 0)
       {
-        startState = string(k, '1') + string(k, '0');
+        close(fds[0]);
+        threadCount = 1;
+        sweepWorker = true;
+        checkpointFile.clear(); // one file cannot hold the checkpoints of several graphs
+        string line = solveInstance(instances[next]);
+        ssize_t written = write(fds[1], line.data(), line.size());
+        _exit(written == (ssize_t)line.size() ? 0 : 1);
       }
-      else if (*argv[argPos] != 'a')
-      {
-        startState = argv[argPos];
-      }
-      // otherwise, don't do anything, should be all 1's
+      close(fds[1]);
+      running[pid] = fds[0];
+      next++;
+      continue;
     }
-    else
+
+    int status;
+    pid_t pid = wait(&status);
+    if (running.count(pid) == 0)
+      continue;
+    string line;
+    char buffer[256];
+    for (ssize_t got; (got = read(running[pid], buffer, sizeof(buffer))) > 0;)
+      line.append(buffer, got);
+    close(running[pid]);
+    running.erase(pid);
+    if (line.empty())
+      cerr << "a sweep instance failed\n";
+    cout << line << flush;
+  }
+}
+
+// sweep(argc, argv) reads the family, ranges and presets of the sweep option and runs the sweep
+void sweep(int argc, char *argv[])
+{
+  char family = argc > 2 ? tolower(argv[2][0]) : ' ';
+  if (argc < 5 || string("pgls").find(family) == string::npos)
+  {
+    cout << "please provide a family (petersen, grid, ladder or subdiv) and two parameter ranges\n";
+    return;
+  }
+  int aLo, aHi, bLo, bHi;
+  parseRange(argv[3], aLo, aHi);
+  parseRange(argv[4], bLo, bHi);
+  string presets = argc > 5 ? argv[5] : "a";
+
+  vector<SweepInstance> instances;
+  for (int a = aLo; a <= aHi; a++)
+  {
+    for (int b = bLo; b <= bHi; b++)
     {
-      startState = argv[argPos];
+      for (char preset : presets)
+      {
+        if (preset != 'a' && preset != 'i' && preset != 'o')
+          continue;
+        if (preset != 'a' && family != 'p' && family != 'l')
+        {
+          cerr << "preset " << preset << " needs an inner and outer half, skipping it for " << familyName(family) << "\n";
+          continue;
+        }
+        int vertices = familyVertices(family, a, b);
+        if (vertices > MAX_VERTICES)
+        {
+          cerr << "skipping " << familyName(family) << " " << a << " " << b << ", which has more than " << MAX_VERTICES << " vertices\n";
+          continue;
+        }
+        instances.push_back({family, a, b, preset, vertices});
+      }
     }
   }
-  return startState;
+  runSweep(instances, threadCount);
 }
 
 // options:
 // petersen n k [i/o/a]
 // grid h w
 // file filename
+// sweep family a b [presets]
 int main(int argc, char *argv[])
 {
-  int n;                                      // number of vertices in the graph
-  nimberComps = unordered_map<string, int>(); // instantiate memoization table
+  int n; // number of vertices in the graph
+  argc = parseFlags(argc, argv);
+  initTable(nimberComps, tableMegabytes << 20); // instantiate memoization table
+  initTable(outcomeComps, tableMegabytes << 20);
+  if (parallelSearch())
+  {
+    if (tableMegabytes == 0)
+      initTable(nimberComps, PARALLEL_TABLE_MEGABYTES << 20);
+    presizeTable(nimberComps);
+  }
 
   // no command line arguments
   if (argc < 2)
@@ -293,11 +632,20 @@ int main(int argc, char *argv[])
   else
   {
     char graphOption = tolower(argv[1][0]);
+    if (splitRegions && parallelSearch() && graphOption != 's')
+    {
+      cout << "-r only splits regions in the single threaded depth first search, so leave out -t or give -t 1\n";
+      return 1;
+    }
     // cout << graphOption << "\n";
 
     // parse the first command line option
     switch (graphOption)
     {
+    case 's': // sweep over a family of graphs
+      sweep(argc, argv);
+      break;
+
     case 'f': // read from file
       if (argc < 3)
       {
@@ -309,11 +657,15 @@ int main(int argc, char *argv[])
         string filename = argv[2]; // get file name
         n = readGraphLines(filename);
         // run game
-        if (n != -1)
+        if (n != -1 && !queryFile.empty())
+        {
+          solveQueries(n);
+        }
+        else if (n != -1)
         {
-          string startState = initializeState(n, argc, 3, argv);
-          int nimVal = runGame(startState, n);
-          cout << "nimber of graph from file " << filename << ": " << nimVal << "\n";
+          State startState = stateFromString(initializeState(n, argc, 3, argv));
+          int nimVal = solve(startState);
+          cout << (outcomeOnly ? "outcome" : "nimber") << " of graph from file " << filename << ": " << resultText(nimVal) << "\n";
         }
       }
       break;
@@ -332,10 +684,15 @@ int main(int argc, char *argv[])
 
         // create the adjacencies
         createGPetersenAdjs(m, k);
+        if (!queryFile.empty())
+        {
+          solveQueries(n);
+          break;
+        }
 
-        string startState = initializeState(n, argc, 4, argv);
-        int nimVal = runGame(startState, n);
-        cout << "nimber of graph from GP(" << m << ", " << k << ") ";
+        State startState = stateFromString(initializeState(n, argc, 4, argv));
+        int nimVal = solve(startState);
+        cout << (outcomeOnly ? "outcome" : "nimber") << " of graph from GP(" << m << ", " << k << ") ";
         if (argc >= 5)
         {
           switch (*argv[4])
@@ -362,7 +719,7 @@ int main(int argc, char *argv[])
         {
           cout << "(no args, all 1's)";
         }
-        cout << ": " << nimVal << "\n";
+        cout << ": " << resultText(nimVal) << "\n";
       }
       break;
 
@@ -380,59 +737,60 @@ int main(int argc, char *argv[])
 
         // create the adjacencies
         createGridAdjs(h, w);
+        if (!queryFile.empty())
+        {
+          solveQueries(n);
+          break;
+        }
 
-        string startState = initializeState(n, argc, 4, argv);
-        int nimVal = runGame(startState, n);
-        cout << "nimber of " << h << " x " << w << "grid: " << nimVal << "\n";
+        State startState = stateFromString(initializeState(n, argc, 4, argv));
+        int nimVal = solve(startState);
+        cout << (outcomeOnly ? "outcome" : "nimber") << " of " << h << " x " << w << "grid: " << resultText(nimVal) << "\n";
       }
       break;
     }
   }
 
-  // nimberComps = unordered_map<string, int>();
+  // clearTable(nimberComps);
   // n = 3;
   // createGridAdjs(3, 1);
-  // string startState = "011";
-  // unordered_set<string> nextStates = getNextStates(n, startState);
-  // for (unordered_set<string>::iterator it = nextStates.begin(); it != nextStates.end(); ++it) {
-  //     cout << *it << ' ';
-  //   }
+  // State startState = stateFromString("011");
+  // State nextStates[MAX_VERTICES];
+  // printSet(nextStates, getNextStates(startState, nextStates));
 
   // generate grids
   // 2 x n grids, 3 x n grids
   // for (int k = 1; k < 20; k++)  {
-  //   nimberComps = unordered_map<string, int>();
+  //   clearTable(nimberComps);
   //   n = 3 * k;
-  //   string startState = string(n, '1');
+  //   State startState = stateFromString(string(n, '1'));
   //   createGridAdjs(3, k);
-  //   int nimVal = runGame(startState, n);
+  //   int nimVal = runGame(startState);
   //   cout << "nimber for 3 x " << k << " grid: " << nimVal << '\n';
   // }
 
   // generate generalized Petersen graphs iteratively
   // for (int k = 23; k < 24; k++)  {
-  //   nimberComps = unordered_map<string, int>();
+  //   clearTable(nimberComps);
   //   n = 2 * k;
-  //   string startState = string(n, '1');
+  //   State startState = stateFromString(string(n, '1'));
   //   createGPetersenAdjs(k, 1);
-  //   int nimVal = runGame(startState, n);
+  //   int nimVal = runGame(startState);
   //   cout << "nimber for GP(" << k << ", 1): " << nimVal << '\n';
   // }
 
   // starting config
-  // string startState = string(n, '1');
+  // State startState = stateFromString(string(n, '1'));
 
   // // unit text for runGame
-  // cout << runGame(startState, n);
+  // cout << runGame(startState);
 
   // // unit test for mex
-  // cout << mex({5, 0, 0, 2, 3});
+  // cout << mex(stateFromString("111011")); // bits 0, 1, 2, 4, 5
 
   // unit test for nextStates
-  // unordered_set<string> nextStates = getNextStates(n, startState);
-  // for (unordered_set<string>::iterator it = nextStates.begin(); it != nextStates.end(); ++it) {
-  //   cout << *it;
-  // }
+  // State nextStates[MAX_VERTICES];
+  // printSet(nextStates, getNextStates(startState, nextStates));
 
   // unit test for graph adjacency
   // cout << "made graph\n";
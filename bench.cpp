@@ -0,0 +1,270 @@
+// bench.cpp times a fixed set of workloads of the toggle engine and the Jacob's Ladder sequence, and prints one JSON line per workload:
+// expand  getNextStates on a fixed pool of random positions of a graph, in expansions (calls) and generated states per second
+// solve   runGame on a pinned instance from a fresh nimber table, in nimbers stored in the table per second, checked against its known nimber
+// octal   jacobsLadderNim and octalSequence, checked against known values and periods of the sequences
+// file    writing a sequence file of grundyfile.h and reading it back with its checksum verified, checked to give the same sequence,
+//         and octalTerms computing a sequence straight into a file mapped with openGrundyTable, checked like octal
+// every line also has the peak resident set size of the process so far, and ok, which is false when a result is wrong.
+// the exit status is 1 if any result is wrong.
+//
+// usage: bench [filter], which runs only the workloads whose kind or name contains filter, e.g. bench solve or bench GP(7,3)
+// build with make bench, which compiles with -O2 and runs every workload
+
+// code compiled with gcc 10.3, may not be backwards compatible with older versions of c++
+#include "toggle.h"
+#include "octal.h"
+#include "grundyfile.h"
+#include <chrono>
+#include <random>
+#include <sys/resource.h>
+
+// EXPANSIONS is the number of getNextStates calls timed for each graph by benchExpand
+const int EXPANSIONS = 4000000;
+// POOL_SIZE is the number of random positions benchExpand cycles through
+const int POOL_SIZE = 1024;
+// BENCH_SEED seeds the random positions, so every run expands the same ones
+const uint64_t BENCH_SEED = 20230601;
+
+// filter is the optional command line argument, and only workloads whose name contains it are run
+string filter;
+// failures counts the workloads whose result did not match the known value
+int failures = 0;
+
+// peakRssKilobytes() returns the largest resident set size of the process so far, in kilobytes
+long peakRssKilobytes()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+// secondsSince(start) returns the time since start in seconds
+double secondsSince(chrono::steady_clock::time_point start)
+{
+  return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// selected(kind, name) decides whether the workload of kind kind called name is run, i.e. whether filter is part of its kind or name
+bool selected(const string &kind, const string &name)
+{
+  return (kind + " " + name).find(filter) != string::npos;
+}
+
+// report(kind, name, fields, ok) prints the JSON line of a workload with its extra fields, which are already formatted as "key":value pairs
+void report(const string &kind, const string &name, const string &fields, bool ok)
+{
+  if (!ok)
+    failures++;
+  cout << "{\"bench\":\"" << kind << "\",\"name\":\"" << name << "\"," << fields << ",\"peak_rss_kb\":" << peakRssKilobytes()
+       << ",\"ok\":" << (ok ? "true" : "false") << "}" << endl;
+}
+
+// number(value) formats value for a JSON line
+string number(double value)
+{
+  char text[32];
+  snprintf(text, sizeof(text), "%.6g", value);
+  return text;
+}
+
+// benchExpand(name) times EXPANSIONS calls of getNextStates on random positions of the current graph, where every vertex is a 1 with probability 1/2
+void benchExpand(const string &name)
+{
+  if (!selected("expand", name))
+    return;
+  mt19937_64 random(BENCH_SEED);
+  vector<State> pool(POOL_SIZE, emptyState());
+  for (int i = 0; i < POOL_SIZE; i++)
+  {
+    for (int v = 0; v < numVertices; v++)
+    {
+      if (random() & 1)
+        setBit(pool[i], v);
+    }
+  }
+
+  State nextStates[MAX_VERTICES];
+  uint64_t generated = 0;
+  uint64_t checksum = 0; // keeps the children live so the calls are not optimized away
+  auto start = chrono::steady_clock::now();
+  for (int i = 0; i < EXPANSIONS; i++)
+  {
+    int count = getNextStates(pool[i % POOL_SIZE], nextStates);
+    generated += count;
+    if (count > 0)
+      checksum ^= nextStates[count - 1].w[0];
+  }
+  double seconds = secondsSince(start);
+  report("expand", name,
+         "\"vertices\":" + to_string(numVertices) + ",\"seconds\":" + number(seconds) + ",\"expansions\":" + to_string(EXPANSIONS) +
+             ",\"states\":" + to_string(generated) + ",\"ns_per_expansion\":" + number(1e9 * seconds / EXPANSIONS) +
+             ",\"states_per_second\":" + number(generated / seconds) + ",\"checksum\":" + to_string(checksum & 0xffff),
+         true);
+}
+
+// benchSolve(name, startState, expected) times runGame from startState on the current graph with an empty nimber table and checks that the nimber is expected.
+// stored is the number of nimbers left in the table, which undercounts the positions solved once entries are replaced
+void benchSolve(const string &name, const string &startState, int expected)
+{
+  if (!selected("solve", name))
+    return;
+  initTable(nimberComps, 0);
+  auto start = chrono::steady_clock::now();
+  int nimVal = runGame(stateFromString(startState));
+  double seconds = secondsSince(start);
+  report("solve", name,
+         "\"vertices\":" + to_string(numVertices) + ",\"seconds\":" + number(seconds) + ",\"stored\":" + to_string(nimberComps.used) +
+             ",\"stored_per_second\":" + number(nimberComps.used / seconds) + ",\"nimber\":" + to_string(nimVal) +
+             ",\"expected\":" + to_string(expected),
+         nimVal == expected);
+}
+
+// benchOctal(n, zeroes, last) times jacobsLadderNim up to n and checks the number of P-positions (zeroes) among 1 through n and the nimber of n
+void benchOctal(int n, int zeroes, int last)
+{
+  string name = "jacobsLadderNim(" + to_string(n) + ")";
+  if (!selected("octal", name))
+    return;
+  vector<uint16_t> values;
+  auto start = chrono::steady_clock::now();
+  jacobsLadderNim(n, values);
+  double seconds = secondsSince(start);
+  int found = count(values.begin() + 1, values.end(), 0);
+  report("octal", name,
+         "\"seconds\":" + number(seconds) + ",\"values_per_second\":" + number(n / seconds) + ",\"zeroes\":" + to_string(found) +
+             ",\"expected_zeroes\":" + to_string(zeroes) + ",\"last\":" + to_string(values[n]) + ",\"expected_last\":" + to_string(last),
+         found == zeroes && values[n] == last);
+}
+
+// benchOctalSequence(code, n, zeroes, last, expectedPeriod, threads) times octalSequence for the octal game code up to n with threads threads and checks it like benchOctal, also reporting how its values split into rare and common ones.
+// with an expectedPeriod the period is watched for and has to be proven equal to it
+void benchOctalSequence(const string &code, uint64_t n, uint64_t zeroes, int last, uint64_t expectedPeriod = 0, int threads = 1)
+{
+  string name = "octalSequence(" + code + "," + to_string(n) + (expectedPeriod > 0 ? ",period" : "") +
+                (threads > 1 ? "," + to_string(threads) + " threads" : "") + ")";
+  if (!selected("octal", name))
+    return;
+  OctalGame game;
+  parseOctalGame(code, game);
+  vector<uint16_t> values;
+  SparseSpace space;
+  auto start = chrono::steady_clock::now();
+  OctalPeriod period;
+  bool complete = octalSequence(game, n, values, space, expectedPeriod > 0 ? &period : nullptr, threads);
+  double seconds = secondsSince(start);
+  uint64_t found = count(values.begin() + 1, values.end(), 0);
+  string periodFields;
+  if (expectedPeriod > 0)
+    periodFields = ",\"period\":" + to_string(period.proven ? period.period : 0) + ",\"expected_period\":" + to_string(expectedPeriod) +
+                   ",\"proven_at\":" + to_string(period.provenAt);
+  report("octal", name,
+         "\"seconds\":" + number(seconds) + ",\"values_per_second\":" + number(n / seconds) + ",\"rare_mask\":" + to_string(space.mask) +
+             ",\"rare\":" + to_string(space.rare) + ",\"pairs\":" + to_string(space.pairs) + ",\"naive_pairs\":" + to_string(space.naivePairs) +
+             ",\"zeroes\":" + to_string(found) + ",\"expected_zeroes\":" + to_string(zeroes) + ",\"last\":" + to_string(values.back()) +
+             ",\"expected_last\":" + to_string(last) + periodFields,
+         complete && found == zeroes && values.back() == last && (expectedPeriod == 0 || (period.proven && period.period == expectedPeriod)));
+}
+
+// benchGrundyFile(code, n) times writeGrundyFile on the sequence of the octal game code up to n, and openGrundyFile with the checksum verified plus readGrundyValues on the file, which is removed afterwards
+void benchGrundyFile(const string &code, uint64_t n)
+{
+  string name = "grundyFile(" + code + "," + to_string(n) + ")";
+  if (!selected("file", name))
+    return;
+  OctalGame game;
+  parseOctalGame(code, game);
+  vector<uint16_t> values, back;
+  SparseSpace space;
+  OctalPeriod period;
+  octalSequence(game, n, values, space, &period);
+  string path = "bench.grundy";
+  auto start = chrono::steady_clock::now();
+  bool ok = writeGrundyFile(path, code, values, true);
+  double writeSeconds = secondsSince(start);
+  GrundyFile file;
+  start = chrono::steady_clock::now();
+  ok = ok && openGrundyFile(file, path, true);
+  if (ok)
+    readGrundyValues(file, back, 0, file.header.terms);
+  double readSeconds = secondsSince(start);
+  uint64_t bytes = file.bytes;
+  closeGrundyFile(file);
+  remove(path.c_str());
+  report("file", name,
+         "\"bytes\":" + to_string(bytes) + ",\"write_seconds\":" + number(writeSeconds) + ",\"read_seconds\":" + number(readSeconds) +
+             ",\"terms_per_second_written\":" + number(values.size() / writeSeconds) + ",\"terms_per_second_read\":" + number(values.size() / readSeconds),
+         ok && back == values);
+}
+
+// benchGrundyTable(code, n, zeroes, last, threads) times octalTerms for the octal game code up to n computed into a sequence file mapped with openGrundyTable, with every split enumerated,
+// and closeGrundyTable, and checks the file like benchOctal. the file is removed afterwards
+void benchGrundyTable(const string &code, uint64_t n, uint64_t zeroes, int last, int threads = 1)
+{
+  string name = "grundyTable(" + code + "," + to_string(n) + (threads > 1 ? "," + to_string(threads) + " threads" : "") + ")";
+  if (!selected("file", name))
+    return;
+  OctalGame game;
+  parseOctalGame(code, game);
+  SparseSpace space;
+  string path = "bench.grundy";
+  GrundyFile file;
+  auto start = chrono::steady_clock::now();
+  bool ok = openGrundyTable(file, path, code, n + 1, false);
+  uint64_t terms = ok ? octalTerms(game, n, grundyTable(file), nullptr, 0, space, nullptr, threads) : 0;
+  ok = ok && closeGrundyTable(file, terms, true);
+  double seconds = secondsSince(start);
+  ok = ok && openGrundyFile(file, path, true) && file.header.terms == n + 1;
+  uint64_t found = ok ? file.header.zeroes : 0;
+  int nimVal = ok ? grundyValue(file, n) : -1;
+  closeGrundyFile(file);
+  remove(path.c_str());
+  report("file", name,
+         "\"seconds\":" + number(seconds) + ",\"values_per_second\":" + number(n / seconds) + ",\"zeroes\":" + to_string(found) +
+             ",\"expected_zeroes\":" + to_string(zeroes) + ",\"last\":" + to_string(nimVal) + ",\"expected_last\":" + to_string(last),
+         ok && found == zeroes && nimVal == last);
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc >= 2)
+    filter = argv[1];
+
+  createGPetersenAdjs(7, 3);
+  benchExpand("GP(7,3)");
+  createGridAdjs(4, 5);
+  benchExpand("grid(4,5)");
+  createLadderTwistAdjs(12, 2);
+  benchExpand("ladder(12,2)");
+
+  // pinned instances and their nimbers, checked against the reference solver
+  createGPetersenAdjs(15, 4);
+  benchSolve("GP(15,4) all", string(30, '1'), 0);
+  createGPetersenAdjs(17, 4);
+  benchSolve("GP(17,4) all", string(34, '1'), 0);
+  createGridAdjs(4, 5);
+  benchSolve("grid(4,5) all", string(20, '1'), 1);
+  createGridAdjs(4, 8);
+  benchSolve("grid(4,8) all", string(32, '1'), 1);
+  createLadderTwistAdjs(12, 2);
+  benchSolve("ladder(12,2) all", string(24, '1'), 2);
+  createLadderTwistAdjs(9, 2);
+  benchSolve("ladder(9,2) outer", string(9, '1') + string(9, '0'), 1);
+
+  // the sequence of octal11337-100k.txt and zeroes-100k.txt
+  benchOctal(100000, 34, 232);
+  benchOctalSequence("0.11337", 100000, 34, 232);
+  // the same in batches across threads, at least two so the batches are used even on one core
+  benchOctalSequence("0.11337", 100000, 34, 232, 0, max(2, (int)thread::hardware_concurrency()));
+  // 0.16 has a sparse space, checked against the direct method up to 10^6
+  benchOctalSequence("0.16", 1000000, 6, 2);
+  // and is proven periodic with period 149459 at heap 509621, after which the rest comes from the period
+  benchOctalSequence("0.16", 1000000, 6, 2, 149459);
+
+  // 4-bit terms, and 0.07 to exercise the P-position index, which has many heaps
+  benchGrundyFile("0.16", 10000000);
+  benchGrundyFile("0.07", 10000000);
+  // the sequence of octal11337-100k.txt again, read backwards from the mapped file and in batches even on one thread
+  benchGrundyTable("0.11337", 100000, 34, 232);
+
+  return failures == 0 ? 0 : 1;
+}
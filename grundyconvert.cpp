@@ -0,0 +1,130 @@
+// grundyconvert.cpp converts nimber sequences between the text files of octal.cpp and jacobsladder.cpp and the binary sequence files of grundyfile.h.
+// usage: grundyconvert tobinary code seqfile out.grundy, e.g. grundyconvert tobinary 0.11337 octal11337-100k.txt octal11337.grundy,
+// reads the nimbers of heaps 1 through n, one per line, and writes them with the P-position index to out.grundy.
+// usage: grundyconvert totext file.grundy seqfile [zeroesfile] writes the nimbers of heaps 1 on of file.grundy one per line, and the heaps that are P-positions to zeroesfile.
+// build with make build-convert
+#include <iostream>
+#include "octal.h"
+#include "grundyfile.h"
+using namespace std;
+
+// readTextSequence(path, values) reads the nimbers of heaps 1 on from the text file at path into values, after the nimber 0 of heap 0.
+// returns false if the file cannot be read or holds something other than nimbers up to OCTAL_MAX_VALUE.
+bool readTextSequence(const string &path, vector<uint16_t> &values)
+{
+  FILE *file = fopen(path.c_str(), "rb");
+  if (file == nullptr)
+    return false;
+  values.assign(1, 0);
+  vector<char> block(GRUNDY_BLOCK_BYTES);
+  long value = -1; // the number being read, or -1 between numbers
+  bool ok = true;
+  for (size_t got; ok && (got = fread(block.data(), 1, block.size(), file)) > 0;)
+  {
+    for (size_t i = 0; i < got && ok; i++)
+    {
+      char c = block[i];
+      if (isdigit(c))
+        value = (value < 0 ? 0 : 10 * value) + (c - '0');
+      else if (c == '\n' || c == '\r' || c == ' ')
+      {
+        if (value >= 0)
+          values.push_back(value);
+        value = -1;
+      }
+      else
+        ok = false;
+      ok = ok && value <= OCTAL_MAX_VALUE;
+    }
+  }
+  if (value >= 0)
+    values.push_back(value);
+  fclose(file);
+  return ok;
+}
+
+// writeTextSequence(file, path, zeroesPath) writes the nimbers of heaps 1 on of file to the text file at path, and the heaps that are P-positions to zeroesPath unless it is empty.
+// the lines are formatted into a block by hand, which is many times faster than writing every number through an ofstream.
+bool writeTextSequence(const GrundyFile &file, const string &path, const string &zeroesPath)
+{
+  FILE *seqFile = fopen(path.c_str(), "wb");
+  FILE *zeroFile = zeroesPath.empty() ? nullptr : fopen(zeroesPath.c_str(), "wb");
+  bool ok = seqFile != nullptr && (zeroesPath.empty() || zeroFile != nullptr);
+  vector<char> seqBlock, zeroBlock;
+  seqBlock.reserve(GRUNDY_BLOCK_BYTES + 32);
+  zeroBlock.reserve(GRUNDY_BLOCK_BYTES + 32);
+  auto append = [](vector<char> &block, uint64_t number)
+  {
+    char digits[24];
+    int length = 0;
+    do
+    {
+      digits[length++] = '0' + number % 10;
+      number /= 10;
+    } while (number > 0);
+    while (length > 0)
+      block.push_back(digits[--length]);
+    block.push_back('\n');
+  };
+  for (uint64_t i = 1; i < file.header.terms && ok; i++)
+  {
+    int nimVal = grundyValue(file, i);
+    append(seqBlock, nimVal);
+    if (nimVal == 0 && zeroFile != nullptr)
+      append(zeroBlock, i);
+    if (seqBlock.size() >= GRUNDY_BLOCK_BYTES)
+    {
+      ok = fwrite(seqBlock.data(), 1, seqBlock.size(), seqFile) == seqBlock.size();
+      seqBlock.clear();
+    }
+    if (zeroBlock.size() >= GRUNDY_BLOCK_BYTES)
+    {
+      ok = ok && fwrite(zeroBlock.data(), 1, zeroBlock.size(), zeroFile) == zeroBlock.size();
+      zeroBlock.clear();
+    }
+  }
+  ok = ok && fwrite(seqBlock.data(), 1, seqBlock.size(), seqFile) == seqBlock.size();
+  ok = ok && (zeroFile == nullptr || fwrite(zeroBlock.data(), 1, zeroBlock.size(), zeroFile) == zeroBlock.size());
+  if (seqFile != nullptr)
+    ok = fclose(seqFile) == 0 && ok;
+  if (zeroFile != nullptr)
+    ok = fclose(zeroFile) == 0 && ok;
+  return ok;
+}
+
+int main(int argc, char *argv[])
+{
+  string mode = argc >= 2 ? argv[1] : "";
+  OctalGame game;
+  if (mode == "tobinary" && argc == 5 && parseOctalGame(argv[2], game))
+  {
+    vector<uint16_t> values;
+    if (!readTextSequence(argv[3], values))
+    {
+      cout << "could not read the sequence in " << argv[3] << "\n";
+      return 1;
+    }
+    if (!writeGrundyFile(argv[4], game.code, values, true))
+    {
+      cout << "could not write " << argv[4] << "\n";
+      return 1;
+    }
+    cout << "wrote the nimbers of heaps 1 through " << values.size() - 1 << " of " << game.code << " to " << argv[4] << "\n";
+    return 0;
+  }
+  if (mode == "totext" && (argc == 4 || argc == 5))
+  {
+    GrundyFile file;
+    if (!openGrundyFile(file, argv[2], true))
+    {
+      cout << argv[2] << " is not a complete sequence file\n";
+      return 1;
+    }
+    bool ok = writeTextSequence(file, argv[3], argc == 5 ? argv[4] : "");
+    cout << (ok ? "wrote" : "could not write") << " the nimbers of heaps 1 through " << file.header.terms - 1 << " of " << file.header.code << "\n";
+    closeGrundyFile(file);
+    return ok ? 0 : 1;
+  }
+  cout << "usage: grundyconvert tobinary code seqfile out.grundy, or grundyconvert totext file.grundy seqfile [zeroesfile]\n";
+  return 1;
+}
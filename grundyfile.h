@@ -0,0 +1,437 @@
+// grundyfile.h holds the binary file format for the nimber sequences of octal.h, shared by octal.cpp, grundyconvert.cpp and bench.cpp.
+// a file is a GrundyHeader padded to GRUNDY_HEADER_BYTES, the terms packed at bits bits each from heap 0 on, and then, if indexed, the heaps from 1 on whose nimber is 0 as uint64_t's starting at the next multiple of 8 bytes.
+// with 4 bits, heap i is the low half of byte i / 2 when i is even and the high half when it is odd. with 16 bits, every term is a little-endian uint16_t.
+// the files are written through large blocks and read back by mapping them into memory, so reading a term is an array lookup.
+// a sequence too large for memory is computed straight into a file mapped with openGrundyTable instead.
+// code compiled with gcc 10.3, may not be backwards compatible with older versions of c++
+#ifndef GRUNDYFILE_H
+#define GRUNDYFILE_H
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+using namespace std;
+
+const uint64_t GRUNDY_FILE_MAGIC = 0x515359444e555247ULL; // "GRUNDYSQ"
+const uint64_t GRUNDY_FILE_VERSION = 1;
+const uint64_t GRUNDY_HEADER_BYTES = 4096;
+// GRUNDY_BLOCK_BYTES is the size of the blocks the terms are packed into before they are written
+const size_t GRUNDY_BLOCK_BYTES = 1 << 20;
+
+// GrundyHeader starts a sequence file
+struct GrundyHeader
+{
+  uint64_t magic;
+  uint64_t version;
+  char code[32];     // the octal code of the game, padded with zeroes
+  uint64_t terms;    // number of terms, the nimbers of heaps 0 through terms - 1
+  uint64_t bits;     // bits per term: 4, 8 or 16
+  uint64_t checksum; // grundyChecksum of the terms
+  uint64_t indexed;  // 1 if the P-position index follows the terms
+  uint64_t zeroes;   // number of heaps in the P-position index
+};
+
+// grundyChecksum(hash, values, count) continues the FNV-1a hash hash over values[0] through values[count - 1], two little-endian bytes each.
+// the hash of a whole sequence starts from GRUNDY_CHECKSUM_START, and it does not depend on how the terms are packed
+const uint64_t GRUNDY_CHECKSUM_START = 0xcbf29ce484222325ULL;
+
+inline uint64_t grundyChecksum(uint64_t hash, const uint16_t *values, uint64_t count)
+{
+  for (uint64_t i = 0; i < count; i++)
+  {
+    hash = (hash ^ (values[i] & 255)) * 0x100000001b3ULL;
+    hash = (hash ^ (values[i] >> 8)) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+// grundyBits(values) returns the fewest bits of 4, 8 and 16 that hold every term of values
+int grundyBits(const vector<uint16_t> &values)
+{
+  uint16_t largest = 0;
+  for (uint16_t v : values)
+    largest = max(largest, v);
+  return largest < 16 ? 4 : largest < 256 ? 8 : 16;
+}
+
+// grundyTermBytes(terms, bits) returns the bytes that terms terms take at bits bits each, and grundyIndexOffset(header) where the P-position index of a file starts
+inline uint64_t grundyTermBytes(uint64_t terms, uint64_t bits)
+{
+  return (terms * bits + 7) / 8;
+}
+
+inline uint64_t grundyIndexOffset(const GrundyHeader &header)
+{
+  return GRUNDY_HEADER_BYTES + (grundyTermBytes(header.terms, header.bits) + 7) / 8 * 8;
+}
+
+// packGrundyTerms(terms, count, bits, out) packs terms[0] through terms[count - 1] at bits bits each into out, starting at a whole byte
+void packGrundyTerms(const uint16_t *terms, uint64_t count, int bits, uint8_t *out)
+{
+  if (bits == 4)
+  {
+    for (uint64_t i = 0; i < count; i += 2)
+      out[i / 2] = terms[i] | (i + 1 < count ? terms[i + 1] << 4 : 0);
+  }
+  else if (bits == 8)
+  {
+    for (uint64_t i = 0; i < count; i++)
+      out[i] = terms[i];
+  }
+  else
+  {
+    for (uint64_t i = 0; i < count; i++)
+    {
+      out[2 * i] = terms[i] & 255;
+      out[2 * i + 1] = terms[i] >> 8;
+    }
+  }
+}
+
+// grundyZeroes(values) returns the heaps from 1 on whose nimber in values is 0, the P-position index of a file
+vector<uint64_t> grundyZeroes(const vector<uint16_t> &values)
+{
+  vector<uint64_t> zeroes;
+  for (uint64_t i = 1; i < values.size(); i++)
+  {
+    if (values[i] == 0)
+      zeroes.push_back(i);
+  }
+  return zeroes;
+}
+
+// writeGrundyFile(path, code, values, indexed) writes values, the nimbers of heaps 0 through values.size() - 1 of the octal game code, to the sequence file at path, with the P-position index if indexed is set.
+// the terms take the fewest bits that hold them. the file is written next to path and renamed over it once it is on disk, so path never holds half a sequence.
+// returns false if the file could not be written.
+bool writeGrundyFile(const string &path, const string &code, const vector<uint16_t> &values, bool indexed)
+{
+  string temp = path + ".tmp";
+  FILE *file = fopen(temp.c_str(), "wb");
+  if (file == nullptr)
+    return false;
+  GrundyHeader header = {};
+  header.magic = GRUNDY_FILE_MAGIC;
+  header.version = GRUNDY_FILE_VERSION;
+  strncpy(header.code, code.c_str(), sizeof(header.code) - 1);
+  header.terms = values.size();
+  header.bits = grundyBits(values);
+  header.checksum = grundyChecksum(GRUNDY_CHECKSUM_START, values.data(), values.size());
+  header.indexed = indexed;
+
+  vector<char> block(GRUNDY_HEADER_BYTES, 0);
+  memcpy(block.data(), &header, sizeof(header));
+  bool ok = fwrite(block.data(), 1, block.size(), file) == block.size();
+  // terms per block, even so that no byte of 4-bit terms is split between blocks
+  uint64_t perBlock = GRUNDY_BLOCK_BYTES * 8 / header.bits;
+  block.assign(GRUNDY_BLOCK_BYTES, 0);
+  for (uint64_t first = 0; first < values.size() && ok; first += perBlock)
+  {
+    uint64_t count = min<uint64_t>(perBlock, values.size() - first);
+    packGrundyTerms(&values[first], count, header.bits, (uint8_t *)block.data());
+    size_t bytes = grundyTermBytes(count, header.bits);
+    ok = fwrite(block.data(), 1, bytes, file) == bytes;
+  }
+
+  if (indexed && ok)
+  {
+    size_t padding = grundyIndexOffset(header) - GRUNDY_HEADER_BYTES - grundyTermBytes(header.terms, header.bits);
+    vector<uint64_t> zeroes = grundyZeroes(values);
+    ok = fwrite("\0\0\0\0\0\0\0", 1, padding, file) == padding && fwrite(zeroes.data(), sizeof(uint64_t), zeroes.size(), file) == zeroes.size();
+    header.zeroes = zeroes.size();
+  }
+  ok = ok && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1 && fflush(file) == 0 && fsync(fileno(file)) == 0;
+  ok = fclose(file) == 0 && ok;
+  if (ok && rename(temp.c_str(), path.c_str()) == 0)
+    return true;
+  remove(temp.c_str());
+  return false;
+}
+
+// appendGrundyFile(path, values) extends the sequence file at path, which holds the first terms of values, to all of values, keeping its P-position index if it has one.
+// the new terms are written after the old ones, unless the largest of them needs more bits than the file packs its terms in, when the whole file is written again with writeGrundyFile.
+// the header first drops the index, which the new terms overwrite, and only takes the new terms once they and the index are on disk, so a run that stops midway leaves the old sequence.
+// returns false if the file does not start with values or could not be written.
+bool appendGrundyFile(const string &path, const vector<uint16_t> &values)
+{
+  int fd = open(path.c_str(), O_RDWR);
+  GrundyHeader header;
+  if (fd < 0 || pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) || header.magic != GRUNDY_FILE_MAGIC ||
+      header.version != GRUNDY_FILE_VERSION || header.terms > values.size() ||
+      grundyChecksum(GRUNDY_CHECKSUM_START, values.data(), header.terms) != header.checksum)
+  {
+    if (fd >= 0)
+      close(fd);
+    return false;
+  }
+  if (grundyBits(values) > (int)header.bits)
+  {
+    close(fd);
+    return writeGrundyFile(path, header.code, values, header.indexed);
+  }
+
+  bool indexed = header.indexed;
+  header.indexed = 0;
+  bool ok = pwrite(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header) && fdatasync(fd) == 0;
+  // with 4 bits the last old term may share its byte with the first new one, so that byte is written again
+  uint64_t perBlock = GRUNDY_BLOCK_BYTES * 8 / header.bits;
+  vector<uint8_t> block(GRUNDY_BLOCK_BYTES);
+  for (uint64_t first = header.terms / 2 * 2; first < values.size() && ok; first += perBlock)
+  {
+    uint64_t count = min<uint64_t>(perBlock, values.size() - first);
+    packGrundyTerms(&values[first], count, header.bits, block.data());
+    size_t bytes = grundyTermBytes(count, header.bits);
+    ok = pwrite(fd, block.data(), bytes, GRUNDY_HEADER_BYTES + first * header.bits / 8) == (ssize_t)bytes;
+  }
+
+  header.checksum = grundyChecksum(header.checksum, values.data() + header.terms, values.size() - header.terms);
+  header.terms = values.size();
+  uint64_t end = GRUNDY_HEADER_BYTES + grundyTermBytes(header.terms, header.bits);
+  if (indexed && ok)
+  {
+    vector<uint64_t> zeroes = grundyZeroes(values);
+    header.zeroes = zeroes.size();
+    end = grundyIndexOffset(header) + 8 * zeroes.size();
+    uint64_t termEnd = GRUNDY_HEADER_BYTES + grundyTermBytes(header.terms, header.bits);
+    uint64_t padding = grundyIndexOffset(header) - termEnd;
+    ok = pwrite(fd, "\0\0\0\0\0\0\0", padding, termEnd) == (ssize_t)padding &&
+         pwrite(fd, zeroes.data(), 8 * zeroes.size(), grundyIndexOffset(header)) == (ssize_t)(8 * zeroes.size());
+  }
+  header.indexed = indexed;
+  ok = ok && ftruncate(fd, end) == 0 && fdatasync(fd) == 0 && pwrite(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header) && fsync(fd) == 0;
+  return close(fd) == 0 && ok;
+}
+
+// GrundyFile is a sequence file mapped into memory for reading, see openGrundyFile
+struct GrundyFile
+{
+  int fd = -1;
+  const char *mapping = nullptr;
+  uint64_t bytes = 0;
+  GrundyHeader header = {};
+  const uint8_t *terms = nullptr;   // the packed terms
+  const uint64_t *zeroes = nullptr; // the P-position index, or nullptr if the file has none
+  string target;                    // for a new file of openGrundyTable, the path closeGrundyTable renames it to
+};
+
+// grundyValue(file, heap) returns the nimber of heap in file
+// precondition: heap is below file.header.terms
+inline int grundyValue(const GrundyFile &file, uint64_t heap)
+{
+  if (file.header.bits == 4)
+    return (file.terms[heap / 2] >> (4 * (heap & 1))) & 15;
+  if (file.header.bits == 8)
+    return file.terms[heap];
+  return file.terms[2 * heap] | file.terms[2 * heap + 1] << 8;
+}
+
+// readGrundyValues(file, values, first, count) unpacks the terms of heaps first through first + count - 1 of file into values
+void readGrundyValues(const GrundyFile &file, vector<uint16_t> &values, uint64_t first, uint64_t count)
+{
+  values.resize(count);
+  for (uint64_t i = 0; i < count; i++)
+    values[i] = grundyValue(file, first + i);
+}
+
+// closeGrundyFile(file) unmaps file and closes it
+void closeGrundyFile(GrundyFile &file)
+{
+  if (file.mapping != nullptr)
+    munmap((void *)file.mapping, file.bytes);
+  if (file.fd >= 0)
+    close(file.fd);
+  file = GrundyFile();
+}
+
+// openGrundyFile(file, path, verify) maps the sequence file at path into file, checking its header and size, and its checksum too if verify is set.
+// returns false, leaving file closed, if path is not a complete sequence file.
+bool openGrundyFile(GrundyFile &file, const string &path, bool verify)
+{
+  closeGrundyFile(file);
+  file.fd = open(path.c_str(), O_RDONLY);
+  struct stat info;
+  if (file.fd < 0 || fstat(file.fd, &info) != 0 || (uint64_t)info.st_size < GRUNDY_HEADER_BYTES)
+  {
+    closeGrundyFile(file);
+    return false;
+  }
+  file.bytes = info.st_size;
+  void *mem = mmap(nullptr, file.bytes, PROT_READ, MAP_SHARED, file.fd, 0);
+  if (mem == MAP_FAILED)
+  {
+    file.bytes = 0;
+    closeGrundyFile(file);
+    return false;
+  }
+  file.mapping = (const char *)mem;
+  memcpy(&file.header, file.mapping, sizeof(file.header));
+  const GrundyHeader &header = file.header;
+  bool ok = header.magic == GRUNDY_FILE_MAGIC && header.version == GRUNDY_FILE_VERSION && header.code[sizeof(header.code) - 1] == 0 &&
+            (header.bits == 4 || header.bits == 8 || header.bits == 16) && header.terms <= (file.bytes - GRUNDY_HEADER_BYTES) * 8 / header.bits &&
+            GRUNDY_HEADER_BYTES + grundyTermBytes(header.terms, header.bits) <= file.bytes &&
+            (!header.indexed || (header.zeroes <= header.terms && grundyIndexOffset(header) + 8 * header.zeroes <= file.bytes));
+  if (ok)
+  {
+    file.terms = (const uint8_t *)file.mapping + GRUNDY_HEADER_BYTES;
+    file.zeroes = header.indexed ? (const uint64_t *)(file.mapping + grundyIndexOffset(header)) : nullptr;
+  }
+  if (ok && verify)
+  {
+    uint64_t hash = GRUNDY_CHECKSUM_START;
+    vector<uint16_t> values;
+    for (uint64_t first = 0; first < header.terms; first += GRUNDY_BLOCK_BYTES)
+    {
+      readGrundyValues(file, values, first, min<uint64_t>(GRUNDY_BLOCK_BYTES, header.terms - first));
+      hash = grundyChecksum(hash, values.data(), values.size());
+    }
+    ok = hash == header.checksum;
+  }
+  if (!ok)
+    closeGrundyFile(file);
+  return ok;
+}
+
+// widenGrundyFile(path) writes the terms of the sequence file at path again at 16 bits, the way writeGrundyFile does, going through them a block at a time.
+// the checksum stays the same, but the P-position index is dropped. returns false if path is not a sequence file or could not be written.
+bool widenGrundyFile(const string &path)
+{
+  GrundyFile old;
+  if (!openGrundyFile(old, path, false))
+    return false;
+  string temp = path + ".tmp";
+  FILE *file = fopen(temp.c_str(), "wb");
+  GrundyHeader header = old.header;
+  header.bits = 16;
+  header.indexed = 0;
+  header.zeroes = 0;
+  vector<char> block(GRUNDY_HEADER_BYTES, 0);
+  memcpy(block.data(), &header, sizeof(header));
+  bool ok = file != nullptr && fwrite(block.data(), 1, block.size(), file) == block.size();
+  block.assign(GRUNDY_BLOCK_BYTES, 0);
+  vector<uint16_t> values;
+  for (uint64_t first = 0; first < header.terms && ok; first += GRUNDY_BLOCK_BYTES / 2)
+  {
+    readGrundyValues(old, values, first, min<uint64_t>(GRUNDY_BLOCK_BYTES / 2, header.terms - first));
+    packGrundyTerms(values.data(), values.size(), 16, (uint8_t *)block.data());
+    ok = fwrite(block.data(), 2, values.size(), file) == values.size();
+  }
+  closeGrundyFile(old);
+  ok = ok && fflush(file) == 0 && fsync(fileno(file)) == 0;
+  if (file != nullptr)
+    ok = fclose(file) == 0 && ok;
+  if (ok && rename(temp.c_str(), path.c_str()) == 0)
+    return true;
+  remove(temp.c_str());
+  return false;
+}
+
+// openGrundyTable(file, path, code, terms, extend) maps the sequence file at path for reading and writing as a table of terms 16-bit terms, so the nimbers of heaps 0 through terms - 1 of the octal game code can be computed straight into it.
+// with extend, path already holds the first terms of the sequence of code, which are kept and rewritten at 16 bits first if they are packed narrower, and file.header.terms is their number.
+// otherwise the sequence is started over in a file next to path, which closeGrundyTable renames over path like writeGrundyFile does.
+// either way the header only takes the new terms in closeGrundyTable, so a run that stops midway leaves path as it was.
+// the table is grundyTable(file), which holds little-endian terms like the file on the little-endian machines this runs on.
+// returns false, leaving file closed, if path could not be opened, or with extend is not a sequence file.
+bool openGrundyTable(GrundyFile &file, const string &path, const string &code, uint64_t terms, bool extend)
+{
+  closeGrundyFile(file);
+  GrundyHeader header = {};
+  if (extend)
+  {
+    if (!openGrundyFile(file, path, false))
+      return false;
+    header = file.header;
+    closeGrundyFile(file);
+    if (header.bits < 16 && !widenGrundyFile(path))
+      return false;
+    header.bits = 16;
+  }
+  else
+  {
+    header.magic = GRUNDY_FILE_MAGIC;
+    header.version = GRUNDY_FILE_VERSION;
+    strncpy(header.code, code.c_str(), sizeof(header.code) - 1);
+    header.bits = 16;
+    header.checksum = GRUNDY_CHECKSUM_START;
+  }
+  // the index goes before the file grows over it
+  header.indexed = 0;
+  header.zeroes = 0;
+  terms = max(terms, header.terms);
+  string name = extend ? path : path + ".tmp";
+  file.fd = open(name.c_str(), O_RDWR | O_CREAT | (extend ? 0 : O_TRUNC), 0644);
+  file.bytes = GRUNDY_HEADER_BYTES + 2 * terms;
+  bool ok = file.fd >= 0 && pwrite(file.fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header) && fdatasync(file.fd) == 0 &&
+            ftruncate(file.fd, file.bytes) == 0;
+  void *mem = ok ? mmap(nullptr, file.bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file.fd, 0) : MAP_FAILED;
+  if (mem == MAP_FAILED)
+  {
+    file.bytes = 0;
+    closeGrundyFile(file);
+    if (!extend)
+      remove(name.c_str());
+    return false;
+  }
+  file.mapping = (const char *)mem;
+  file.header = header;
+  file.target = extend ? "" : path;
+  file.terms = (const uint8_t *)file.mapping + GRUNDY_HEADER_BYTES;
+  return true;
+}
+
+// grundyTable(file) returns the terms of a file opened with openGrundyTable, which may be written
+inline uint16_t *grundyTable(GrundyFile &file)
+{
+  return (uint16_t *)(file.mapping + GRUNDY_HEADER_BYTES);
+}
+
+// closeGrundyTable(file, terms, indexed) finishes a file opened with openGrundyTable whose table holds terms terms: the terms are flushed to disk,
+// the checksum and the P-position index if indexed is set are computed a block at a time, and the header takes the terms last, before file is closed and a new file is renamed over its path.
+// returns false if the file could not be written.
+bool closeGrundyTable(GrundyFile &file, uint64_t terms, bool indexed)
+{
+  const uint16_t *table = grundyTable(file);
+  GrundyHeader &header = file.header;
+  bool ok = msync((void *)file.mapping, file.bytes, MS_SYNC) == 0;
+  header.checksum = grundyChecksum(header.checksum, table + header.terms, terms - header.terms);
+  header.terms = terms;
+  header.indexed = indexed;
+  uint64_t end = GRUNDY_HEADER_BYTES + 2 * terms;
+  if (indexed && ok)
+  {
+    // the index starts right after the terms, or after the padding that rounds 16-bit terms up to a multiple of 8 bytes
+    uint64_t padding = grundyIndexOffset(header) - end;
+    ok = pwrite(file.fd, "\0\0\0\0\0\0\0", padding, end) == (ssize_t)padding;
+    end = grundyIndexOffset(header);
+    vector<uint64_t> zeroes;
+    for (uint64_t i = 1; i <= terms && ok; i++)
+    {
+      if (i < terms && table[i] == 0)
+        zeroes.push_back(i);
+      if (zeroes.size() == GRUNDY_BLOCK_BYTES / 8 || (i == terms && !zeroes.empty()))
+      {
+        ok = pwrite(file.fd, zeroes.data(), 8 * zeroes.size(), end) == (ssize_t)(8 * zeroes.size());
+        end += 8 * zeroes.size();
+        header.zeroes += zeroes.size();
+        zeroes.clear();
+      }
+    }
+  }
+  ok = ok && ftruncate(file.fd, end) == 0 && fdatasync(file.fd) == 0 && pwrite(file.fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header) &&
+       fsync(file.fd) == 0;
+  string target = file.target;
+  closeGrundyFile(file);
+  if (target.empty())
+    return ok;
+  string temp = target + ".tmp";
+  if (ok && rename(temp.c_str(), target.c_str()) == 0)
+    return true;
+  remove(temp.c_str());
+  return false;
+}
+
+#endif
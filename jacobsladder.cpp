@@ -3,65 +3,9 @@
 #include <vector>
 #include <unordered_set>
 #include <fstream>
+#include "octal.h"
 using namespace std;
 
-vector<int> memTable;
-
-// mex(natSet) computes the minimum excluded natural number of a set of integers
-int mex(unordered_set<int> natSet)
-{
-  int currMex = 0;
-  while (natSet.count(currMex) == 1)
-  {
-    currMex++;
-  }
-  return currMex;
-}
-
-// compute the nimber for the Jacob's Ladder game for all n
-// precondition: n is at least 0
-int jacobsLadderNim(int n, ofstream *nums, ofstream *zeroes)
-{
-
-  // loop invariant -- everything from 1 to i has been computed
-  for (int i = 1; i <= n; i++)
-  {
-    if (i <= 6) // base case
-    {
-      int base = memTable[i];
-      *nums << base << "\n";
-      if (base == 0)
-      {
-        *zeroes << i << "\n";
-      }
-    }
-    else // non base case
-    {
-      unordered_set<int> childNims;
-      childNims.insert(memTable[i - 3]);
-      childNims.insert(memTable[i - 4]);
-      childNims.insert(memTable[i - 5]);
-
-      for (int k = 1; k <= i - 6; k++)
-      {
-        int leftVal = memTable[k];
-        int rightVal = memTable[i - 5 - k];
-        childNims.insert(leftVal ^ rightVal);
-      }
-
-      int nimVal = mex(childNims);
-      *nums << nimVal << "\n";
-      if (nimVal == 0)
-      {
-        *zeroes << i << "\n";
-      }
-      memTable.push_back(nimVal);
-    }
-  }
-
-  return memTable[n];
-}
-
 // isNumber(number) computes whether number is a string that can be parsed as a number
 // taken from https://stackoverflow.com/questions/29248585/c-checking-command-line-argument-is-integer-or-not
 bool isNumber(char number[])
@@ -77,20 +21,14 @@ bool isNumber(char number[])
 
 int main(int argc, char *argv[])
 {
-  // put in initial values
-  memTable.push_back(0); // n = 0
-  memTable.push_back(1); // n = 1
-  memTable.push_back(1); // n = 2
-  memTable.push_back(1); // n = 3
-  memTable.push_back(2); // n = 4
-  memTable.push_back(2); // n = 5
-  memTable.push_back(0); // n = 6
-
-  // parse command line args
-  int n = 100;
-  if (argc >= 2 && isNumber(argv[1]))
+  // parse command line args: jacobsladder [n] [threads], where threads is one per core by default
+  uint64_t n = 100;
+  int threads = max(1, (int)thread::hardware_concurrency());
+  if (argc >= 2 && isNumber(argv[1]) && (argc < 3 || isNumber(argv[2])))
   {
-    n = stoi(argv[1]);
+    n = stoull(argv[1]);
+    if (argc >= 3)
+      threads = max(1, stoi(argv[2]));
   }
   else if (argc >= 2)
   {
@@ -105,7 +43,16 @@ int main(int argc, char *argv[])
 
   cout << "computing\n";
   // computes all nimbers through n - 3, inclusive
-  jacobsLadderNim(n, &seqFile, &zeroFile);
+  vector<uint16_t> values;
+  jacobsLadderNim(n, values, threads);
+  for (uint64_t i = 1; i <= n; i++)
+  {
+    seqFile << values[i] << "\n";
+    if (values[i] == 0)
+    {
+      zeroFile << i << "\n";
+    }
+  }
 
   zeroFile.close();
   seqFile.close();
@@ -0,0 +1,150 @@
+// octal.cpp computes the nimber sequence of any octal game, like jacobsladder.cpp does for 0.11337
+// usage: octal code n, e.g. octal 0.11337 100000, which writes the nimbers of heaps 1 through n to octal<digits>.txt and the
+// heaps that are P-positions to zeroes<digits>.txt, where digits is the code without its dot and a leading 0.
+// once the sequence is proven periodic, by the periodicity theorem for octal games, the rest is filled in from the period and
+// the period and preperiod are printed. add -n after n to compute every term instead, and -t threads to compute with threads threads,
+// by default one per core, which gives the same sequence as one thread. with -b the nimbers of heaps 0 through n and the P-positions are written
+// to the binary sequence file octal<digits>.grundy of grundyfile.h instead of the text files. with -e, which implies -b, the sequence already
+// in octal<digits>.grundy is checked against its checksum and extended to n, computing only the heaps after it and appending them to the file.
+// with -m, which implies -b, the nimbers are computed straight into octal<digits>.grundy mapped into memory instead of into memory, with 16 bits per term,
+// so n is only limited by the disk. the page cache keeps the terms that are read most in memory, since every heap reads the terms before it as two sequential streams.
+// watching for a period still keeps its candidate periods in memory, up to 16 bytes per term, so the largest runs add -n
+#include <iostream>
+#include <fstream>
+#include "octal.h"
+#include "grundyfile.h"
+using namespace std;
+
+// isNumber(number) computes whether number is a string that can be parsed as a number
+bool isNumber(char number[])
+{
+  for (int i = 0; number[i] != 0; i++)
+  {
+    if (!isdigit(number[i]))
+      return false;
+  }
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  OctalGame game;
+  if (argc < 3 || !parseOctalGame(argv[1], game) || !isNumber(argv[2]))
+  {
+    cout << "please provide an octal code like 0.11337 and the largest heap\n";
+    return 1;
+  }
+  uint64_t n = stoull(argv[2]);
+  string digits = game.code.substr(game.code.find('.') + 1);
+  if (game.code[0] != '0' && game.code[0] != '.')
+    digits = game.code[0] + digits;
+
+  vector<uint16_t> values;
+  SparseSpace space;
+  OctalPeriod period;
+  bool watch = true;
+  bool binary = false;
+  bool extend = false;
+  bool mapped = false;
+  int threads = max(1, (int)thread::hardware_concurrency());
+  for (int i = 3; i < argc; i++)
+  {
+    if (string(argv[i]) == "-n")
+      watch = false;
+    else if (string(argv[i]) == "-b")
+      binary = true;
+    else if (string(argv[i]) == "-e")
+      binary = extend = true;
+    else if (string(argv[i]) == "-m")
+      binary = mapped = true;
+    else if (string(argv[i]) == "-t" && i + 1 < argc && isNumber(argv[i + 1]))
+      threads = max(1, stoi(argv[++i]));
+  }
+  string binaryPath = "octal" + digits + ".grundy";
+  uint64_t known = 0;
+  GrundyFile file;
+  if (extend && openGrundyFile(file, binaryPath, true))
+  {
+    OctalGame stored;
+    if (!parseOctalGame(file.header.code, stored) || stored.digits != game.digits)
+    {
+      cout << binaryPath << " holds the sequence of " << file.header.code << ", not of " << game.code << "\n";
+      return 1;
+    }
+    known = file.header.terms;
+    if (!mapped)
+      readGrundyValues(file, values, 0, known);
+    closeGrundyFile(file);
+    if (known > n)
+    {
+      cout << binaryPath << " already holds heaps 0 through " << known - 1 << "\n";
+      return 0;
+    }
+    cout << "extending the " << known << " terms of " << binaryPath << "\n";
+  }
+  else if (extend && access(binaryPath.c_str(), F_OK) == 0)
+  {
+    cout << binaryPath << " is not a complete sequence file, so it is left alone\n";
+    return 1;
+  }
+
+  cout << "computing\n";
+  uint64_t terms;
+  bool written = true;
+  if (mapped)
+  {
+    GrundyFile table;
+    if (!openGrundyTable(table, binaryPath, game.code, n + 1, known > 0))
+    {
+      cout << "could not map " << binaryPath << "\n";
+      return 1;
+    }
+    terms = octalTerms(game, n, grundyTable(table), nullptr, known, space, watch ? &period : nullptr, threads);
+    written = closeGrundyTable(table, terms, true);
+  }
+  else
+  {
+    extendOctalSequence(game, n, values, space, watch ? &period : nullptr, threads);
+    terms = values.size();
+  }
+  bool complete = terms == n + 1;
+  if (!complete)
+    cout << "nimbers grow past " << OCTAL_MAX_VALUE << " at heap " << terms << ", stopping there\n";
+
+  if (binary && !mapped)
+    written = known > 0 ? appendGrundyFile(binaryPath, values) : writeGrundyFile(binaryPath, game.code, values, true);
+  if (!written)
+  {
+    cout << "could not write " << binaryPath << "\n";
+    return 1;
+  }
+  if (!binary)
+  {
+    ofstream seqFile("octal" + digits + ".txt");
+    ofstream zeroFile("zeroes" + digits + ".txt");
+    for (uint64_t i = 1; i < values.size(); i++)
+    {
+      seqFile << values[i] << "\n";
+      if (values[i] == 0)
+      {
+        zeroFile << i << "\n";
+      }
+    }
+  }
+
+  if (period.proven)
+    cout << "periodic with period " << period.period << " and preperiod " << period.preperiod << ", proven at heap " << period.provenAt << "\n";
+  else if (watch)
+    cout << "not proven periodic up to heap " << terms - 1 << "\n";
+
+  // how well the sparse space split worked: the method only saves work while rare terms are few
+  cout << "best rare mask " << space.bestMask << ": " << space.bestRare << " of the first " << space.bestTerms << " terms rare ("
+       << 100.0 * space.bestRare / max<uint64_t>(1, space.bestTerms) << "%), ";
+  if (space.mask == 0)
+    cout << "too many for the sparse space, so every split was enumerated\n";
+  else
+    cout << space.fullScans << " terms needed every split scanned\n";
+  cout << "examined " << space.pairs << " splits of " << space.naivePairs << " ("
+       << 100.0 * space.pairs / max<uint64_t>(1, space.naivePairs) << "%)\n";
+  return complete ? 0 : 1;
+}
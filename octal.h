@@ -0,0 +1,497 @@
+// octal.h holds the nimber sequences of octal games shared by jacobsladder.cpp, octal.cpp and bench.cpp.
+// the Jacob's Ladder game is the octal game 0.11337, whose options from a row of m >= 7 are rows of m - 3, m - 4 and m - 5, and two rows of a and m - 5 - a.
+// code compiled with gcc 10.3, may not be backwards compatible with older versions of c++
+#ifndef OCTAL_H
+#define OCTAL_H
+
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <queue>
+#include "parallel.h"
+using namespace std;
+
+// OctalGame is an octal game given by its code d0.d1d2d3..., where digit dk says how a move may take k tokens from a heap:
+// bit 1 allows taking the whole heap, bit 2 leaving one smaller heap, and bit 4 leaving two nonempty heaps.
+struct OctalGame
+{
+  string code;
+  vector<int> digits; // digits[k] is dk
+};
+
+// parseOctalGame(code, game) reads an octal code like 0.11337, .137 or 4.07 into game, returning false if code is not one
+bool parseOctalGame(const string &code, OctalGame &game)
+{
+  size_t dot = code.find('.');
+  if (dot == string::npos || dot > 1 || code.size() < dot + 2)
+    return false;
+  game.code = code;
+  game.digits.assign(1, dot == 0 ? 0 : code[0] - '0');
+  for (size_t i = dot + 1; i < code.size(); i++)
+    game.digits.push_back(code[i] - '0');
+  for (int d : game.digits)
+  {
+    if (d < 0 || d > 7)
+      return false;
+  }
+  // d0 can only split a heap, since taking nothing and leaving the heap as it is would not be a move
+  return (game.digits[0] & 3) == 0;
+}
+
+// OCTAL_MAX_VALUE is the largest nimber the sequences are stored with, one uint16_t per term.
+// a byte per term would not do: the nimbers of 0.11337 already reach 805 below heap 100000
+const int OCTAL_MAX_VALUE = 65535;
+
+// markSplits(left, right, count, seen, stamp) marks left[i] ^ right[i] in seen with stamp for every i below count.
+// the terms are XORed four at a time as 64-bit words, so the loop is bound by the stores to seen alone; AVX2 and AVX-512 kernels were not faster
+template <typename Mark>
+inline void markSplits(const uint16_t *left, const uint16_t *right, uint64_t count, Mark *seen, Mark stamp)
+{
+  uint64_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    uint64_t x, y;
+    memcpy(&x, left + i, 8);
+    memcpy(&y, right + i, 8);
+    x ^= y;
+    seen[x & 0xffff] = stamp;
+    seen[(x >> 16) & 0xffff] = stamp;
+    seen[(x >> 32) & 0xffff] = stamp;
+    seen[x >> 48] = stamp;
+  }
+  for (; i < count; i++)
+    seen[left[i] ^ right[i]] = stamp;
+}
+
+// markSplitsBackward(left, right, count, seen, stamp) marks left[i] ^ right[-i] in seen with stamp for every i below count like markSplits,
+// reading right backwards from the larger part of a split, so no reversed copy of the sequence is needed.
+// the four terms of every word of right are swapped around to line up with left, which makes it about 15% slower than markSplits
+template <typename Mark>
+inline void markSplitsBackward(const uint16_t *left, const uint16_t *right, uint64_t count, Mark *seen, Mark stamp)
+{
+  uint64_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    uint64_t x, y;
+    memcpy(&x, left + i, 8);
+    memcpy(&y, right - i - 3, 8);
+    y = y >> 32 | y << 32;
+    y = (y >> 16 & 0x0000ffff0000ffffULL) | (y & 0x0000ffff0000ffffULL) << 16;
+    x ^= y;
+    seen[x & 0xffff] = stamp;
+    seen[(x >> 16) & 0xffff] = stamp;
+    seen[(x >> 32) & 0xffff] = stamp;
+    seen[x >> 48] = stamp;
+  }
+  for (; i < count; i++)
+    seen[left[i] ^ *(right - i)] = stamp;
+}
+
+// SparseSpace is how octalSequence splits the nimbers of a sequence into common and rare values, and what that saves.
+// v is rare when v & mask has an even number of bits. the XOR of two common values is then rare, so every common value among the options of a heap comes from a split with a rare part, and only those splits are enumerated.
+// the rare values among the options are found by scanning the splits only until each rare value below the smallest missing common value is seen.
+// this pays off as long as rare terms are few, which rare / terms tells; 0 is always rare, so the P-positions are among the rare terms.
+// when even the best mask leaves more than SPARSE_MAX_RARE_FRACTION of the terms rare, the mask is 0: every value is rare and every split is enumerated directly.
+const double SPARSE_MAX_RARE_FRACTION = 1.0 / 16;
+
+struct SparseSpace
+{
+  uint32_t mask = 0;       // a value v is rare when v & mask has an even number of bits
+  uint32_t bestMask = 0;   // the mask with the fewest rare terms, used as mask unless it leaves too many rare
+  uint64_t bestRare = 0;   // terms rare for bestMask among the bestTerms terms it was chosen from
+  uint64_t bestTerms = 0;
+  uint64_t rare = 0;       // terms whose nimber is rare
+  uint64_t terms = 0;      // terms computed
+  uint64_t pairs = 0;      // splits examined
+  uint64_t naivePairs = 0; // splits the direct method examines, all of them for every term
+  uint64_t fullScans = 0;  // terms whose nimber is rare and below every missing common value, which need every split scanned
+};
+
+// isRare(space, v) decides whether v is a rare value of space
+inline bool isRare(const SparseSpace &space, int v)
+{
+  return __builtin_parity(v & space.mask) == 0;
+}
+
+// chooseSparseMask(values, count, space) sets the bestMask of space to the one that makes the fewest of values[0] through values[count - 1] rare, and its mask to it if few enough terms are rare.
+// the number of rare terms for every mask at once is a Walsh-Hadamard transform of the histogram of the values: a term adds 1 to the masks it is rare for and -1 to the others.
+void chooseSparseMask(const uint16_t *values, uint64_t count, SparseSpace &space)
+{
+  int top = 1;
+  for (uint64_t i = 0; i < count; i++)
+  {
+    while (values[i] >= top)
+      top *= 2;
+  }
+  vector<int64_t> balance(top, 0);
+  for (uint64_t i = 0; i < count; i++)
+    balance[values[i]]++;
+  for (int len = 1; len < top; len *= 2)
+  {
+    for (int i = 0; i < top; i += 2 * len)
+    {
+      for (int j = i; j < i + len; j++)
+      {
+        int64_t x = balance[j], y = balance[j + len];
+        balance[j] = x + y;
+        balance[j + len] = x - y;
+      }
+    }
+  }
+  // balance[m] is the number of terms rare for m minus the others, so the fewest rare terms is the smallest balance, and mask 0 makes every term rare
+  space.bestMask = 0;
+  for (int m = 1; m < top; m++)
+  {
+    if (balance[m] < balance[space.bestMask])
+      space.bestMask = m;
+  }
+  space.bestRare = (count + balance[space.bestMask]) / 2;
+  space.bestTerms = count;
+  space.mask = space.bestRare <= SPARSE_MAX_RARE_FRACTION * count ? space.bestMask : 0;
+}
+
+// OctalPeriod is what findPeriod has proven about a sequence: from heap preperiod on, every nimber repeats period heaps later
+struct OctalPeriod
+{
+  bool proven = false;
+  uint64_t preperiod = 0;
+  uint64_t period = 0;
+  uint64_t provenAt = 0; // the heap whose nimber completed the proof
+};
+
+// PeriodFinder proves a sequence periodic while it grows, with the periodicity theorem for octal games:
+// if G(m + p) = G(m) for every m with n0 <= m < 2 n0 + p + t, where t is the largest number of tokens a move takes, then G(m + p) = G(m) for every m >= n0.
+// for a period p whose latest mismatch G(m) != G(m - p) is at lastBad, that takes the nimbers up to 2 lastBad + t + 1, so p is not looked at again before that heap.
+// once there, only the heaps since lastBad are compared, from the newest down: for a wrong p the newest heaps soon give a mismatch, which puts p to sleep for twice as long again.
+// so every p is woken about log(n / p) times, and the proof is found at the first heap where the theorem applies.
+// the theorem needs n0 >= 1, since its proof shrinks the larger heap of an option by p and that heap must not become empty, so a sequence periodic from heap 0 is proven from heap 1 and then checked at heap 0.
+struct PeriodFinder
+{
+  uint64_t t = 0;
+  // heap of (heap at which to look at p again, p), soonest first
+  priority_queue<pair<uint64_t, uint64_t>, vector<pair<uint64_t, uint64_t>>, greater<pair<uint64_t, uint64_t>>> wakeups;
+};
+
+// initPeriodFinder(finder, game) prepares finder for the sequence of game
+void initPeriodFinder(PeriodFinder &finder, const OctalGame &game)
+{
+  finder = PeriodFinder();
+  for (int k = 0; k < (int)game.digits.size(); k++)
+  {
+    if (game.digits[k] != 0)
+      finder.t = k;
+  }
+}
+
+// findPeriod(finder, values, h, period) looks for a proof of periodicity once values[h] is known, and fills period and returns true if there is one.
+// it has to be called for every heap in turn. a period p is taken up at heap 2p + t + 1, the first heap that can prove it with n0 = 1.
+bool findPeriod(PeriodFinder &finder, const uint16_t *values, uint64_t h, OctalPeriod &period)
+{
+  if (h >= finder.t + 3 && (h - finder.t - 1) % 2 == 0)
+    finder.wakeups.push({h, (h - finder.t - 1) / 2});
+  while (!finder.wakeups.empty() && finder.wakeups.top().first <= h)
+  {
+    uint64_t wake = finder.wakeups.top().first, p = finder.wakeups.top().second;
+    finder.wakeups.pop();
+    uint64_t lastBad = (wake - finder.t - 1) / 2;
+    uint64_t m = h;
+    while (m > lastBad && values[m] == values[m - p])
+      m--;
+    if (m > lastBad)
+    {
+      finder.wakeups.push({2 * m + finder.t + 1, p});
+      continue;
+    }
+    // wakeups with the same heap come out smallest p first, so this is the smallest period proven at h
+    period.proven = true;
+    period.preperiod = lastBad + 1 - p;
+    if (period.preperiod == 1 && values[p] == values[0])
+      period.preperiod = 0;
+    period.period = p;
+    period.provenAt = h;
+    return true;
+  }
+  return false;
+}
+
+// OCTAL_BATCH_FROM is the first heap octalTerms takes in batches, since the heaps before it take no time.
+// a batch of heaps from h on holds h / OCTAL_BATCH_DIVISOR of them, and the options marked for them take at most OCTAL_BATCH_BYTES.
+// the splits of a batch are walked OCTAL_TILE left parts at a time for every heap of the batch, so the terms a tile pairs up stay in the caches while they are used,
+// and a table mapped from a file is read about once per batch instead of once per heap.
+const uint64_t OCTAL_BATCH_FROM = 4096;
+const uint64_t OCTAL_BATCH_DIVISOR = 64;
+const uint64_t OCTAL_BATCH_BYTES = 1 << 25;
+const uint64_t OCTAL_TILE = 1 << 15;
+
+// octalTerms(game, n, values, reversed, known, space, period, threads) computes the nimbers of game for heaps known through n into values[known] through values[n], with the sparse space method described at SparseSpace.
+// values[0] through values[known - 1] already hold nimbers, for a sequence loaded from a file, and the mask, the rare terms and findPeriod are first caught up on them.
+// reversed has room for n + 1 terms and is filled with reversed[n - h] = values[h], so the right parts of the splits of a heap are read forwards alongside their left parts.
+// without it they are read backwards with markSplitsBackward, which is slower but needs no memory besides values: values may then be a table mapped from a file,
+// which is read in sequential streams, forwards from heap 1 and backwards from the heap being computed.
+// the mask of space is chosen again from the nimbers so far whenever the number of terms reaches a power of two, starting from mask 0, where every value is rare and every split is enumerated.
+// with period given, the sequence is watched with findPeriod, and once it is proven periodic the rest of values is copied from one period earlier instead of computed.
+// while every split is enumerated, with several threads or without reversed, heaps are taken in batches: the splits of every heap of a batch whose parts both come before the batch are marked first, split across threads threads by heaps,
+// and the heaps are then finished in order with the splits that have a part inside the batch, which are at most 1 / OCTAL_BATCH_DIVISOR of them.
+// the options found are the same either way, so the values do not depend on the number of threads.
+// returns the number of terms in values, n + 1 unless a nimber is above OCTAL_MAX_VALUE, when only the terms before it are computed.
+uint64_t octalTerms(const OctalGame &game, uint64_t n, uint16_t *values, uint16_t *reversed, uint64_t known, SparseSpace &space, OctalPeriod *period = nullptr, int threads = 1)
+{
+  known = min(known, n + 1);
+  // markPairs(a, rest, count, seen, stamp) marks the splits of rest into a + i and rest - a - i for every i below count
+  auto markPairs = [&](uint64_t a, uint64_t rest, uint64_t count, auto *seen, auto stamp)
+  {
+    if (reversed != nullptr)
+      markSplits(&values[a], &reversed[n - rest + a], count, seen, stamp);
+    else
+      markSplitsBackward(&values[a], &values[rest - a], count, seen, stamp);
+  };
+  space = SparseSpace();
+  vector<int> splits; // removals that may leave two heaps
+  for (int k = 0; k < (int)game.digits.size(); k++)
+  {
+    if (game.digits[k] & 4)
+      splits.push_back(k);
+  }
+  // heaps with a rare nimber, in increasing order. with mask 0 every term is rare and the direct split loop never reads them,
+  // so only their number is kept in space.rare and the terms cost no memory besides values
+  vector<uint64_t> rareTerms;
+  // seen[v] == stamp marks v as the nimber of an option of the current heap, so seen never needs clearing
+  vector<uint64_t> seen(2, 0);
+  int top = 1; // a power of two above every nimber so far, so every option is below top and the mex at most top
+  // the current batch is the heaps from batchStart to batchEnd - 1, and batchSeen[(h - batchStart) * batchTop + v] is 1 if v is an option of h found ahead
+  uint64_t batchStart = 0, batchEnd = 0;
+  int batchTop = 0;
+  vector<uint8_t> batchSeen;
+  PeriodFinder finder;
+  if (period != nullptr)
+  {
+    *period = OctalPeriod();
+    initPeriodFinder(finder, game);
+  }
+
+  // catch up on the known nimbers: the mask is the one chosen at the last power of two among them
+  for (uint64_t h = 0; h < known; h++)
+  {
+    while (values[h] >= top)
+      top *= 2;
+    if (reversed != nullptr)
+      reversed[n - h] = values[h];
+  }
+  seen.resize(top + 1, 0);
+  uint64_t lastChoice = 1;
+  while (2 * lastChoice < known)
+    lastChoice *= 2;
+  if (lastChoice >= 64)
+    chooseSparseMask(values, lastChoice, space);
+  for (uint64_t h = 0; h < known && space.mask != 0; h++)
+  {
+    if (isRare(space, values[h]))
+      rareTerms.push_back(h);
+  }
+  space.rare = space.mask == 0 ? known : rareTerms.size();
+  for (uint64_t h = 0; h < known && period != nullptr; h++)
+  {
+    if (findPeriod(finder, values, h, *period))
+    {
+      for (uint64_t m = known; m <= n; m++)
+        values[m] = values[m - period->period];
+      return n + 1;
+    }
+  }
+
+  for (uint64_t h = known; h <= n; h++)
+  {
+    if (h >= 64 && (h & (h - 1)) == 0)
+    {
+      chooseSparseMask(values, h, space);
+      rareTerms.clear();
+      if (space.mask == 0)
+        rareTerms.shrink_to_fit();
+      for (uint64_t i = 0; i < h && space.mask != 0; i++)
+      {
+        if (isRare(space, values[i]))
+          rareTerms.push_back(i);
+      }
+      space.rare = space.mask == 0 ? h : rareTerms.size();
+    }
+
+    if (space.mask == 0 && h >= batchEnd && h >= OCTAL_BATCH_FROM && (threads > 1 || reversed == nullptr))
+    {
+      // a batch ends before the next power of two, where the mask is chosen again
+      uint64_t nextChoice = 1;
+      while (nextChoice <= h)
+        nextChoice *= 2;
+      batchStart = h;
+      batchTop = top;
+      uint64_t size = max<uint64_t>(1, min<uint64_t>(h / OCTAL_BATCH_DIVISOR, OCTAL_BATCH_BYTES / top));
+      batchEnd = min({n + 1, h + size, nextChoice});
+      uint64_t count = batchEnd - batchStart;
+      batchSeen.assign(count * batchTop, 0);
+      // every thread takes a run of heaps of the batch and goes through the left parts of their splits a tile at a time
+      int groups = (int)min<uint64_t>(max(1, threads), count);
+      parallelFor(groups, groups, [&](size_t group, size_t, int)
+      {
+        uint64_t first = batchStart + count * group / groups, last = batchStart + count * (group + 1) / groups;
+        for (uint64_t tile = 1; 2 * tile < last; tile += OCTAL_TILE)
+        {
+          for (uint64_t heap = first; heap < last; heap++)
+          {
+            uint8_t *mine = &batchSeen[(heap - batchStart) * batchTop];
+            for (int k : splits)
+            {
+              if (heap < (uint64_t)k + 2)
+                continue;
+              // the splits of rest into a and rest - a with a in the tile and rest - a < batchStart
+              uint64_t rest = heap - k;
+              uint64_t low = max(tile, rest >= batchStart ? rest - batchStart + 1 : 1), high = min(rest / 2, tile + OCTAL_TILE - 1);
+              if (low <= high)
+                markPairs(low, rest, high - low + 1, mine, (uint8_t)1);
+            }
+          }
+        }
+      });
+    }
+
+    uint64_t stamp = h + 1;
+    for (int k = 1; k < (int)game.digits.size() && k <= (int)h; k++)
+    {
+      if ((game.digits[k] & 1) && h == (uint64_t)k)
+        seen[0] = stamp;
+      if ((game.digits[k] & 2) && h > (uint64_t)k)
+        seen[values[h - k]] = stamp;
+    }
+    // every split with a rare part, which gives every common option. a split with two rare parts is only taken from its smaller part.
+    // with mask 0 that is every split, which is walked directly as values[a] and values[rest - a] for a from 1 to rest / 2.
+    for (int k : splits)
+    {
+      if (h < (uint64_t)k + 2)
+        continue;
+      uint64_t rest = h - k;
+      space.naivePairs += rest / 2;
+      if (space.mask == 0)
+      {
+        // in a batch, only the splits with a part inside it are left
+        uint64_t count = rest / 2;
+        if (h < batchEnd)
+          count = rest >= batchStart ? min(count, rest - batchStart) : 0;
+        markPairs(1, rest, count, seen.data(), stamp);
+        space.pairs += rest / 2;
+        continue;
+      }
+      for (size_t r = 0; r < rareTerms.size() && rareTerms[r] < rest; r++)
+      {
+        uint64_t a = rareTerms[r];
+        if (a == 0 || (2 * a > rest && isRare(space, values[rest - a])))
+          continue;
+        seen[values[a] ^ values[rest - a]] = stamp;
+        space.pairs++;
+      }
+    }
+
+    if (h < batchEnd)
+    {
+      const uint8_t *mine = &batchSeen[(h - batchStart) * batchTop];
+      for (int v = 0; v < batchTop; v++)
+      {
+        if (mine[v])
+          seen[v] = stamp;
+      }
+    }
+
+    // common is the smallest common value that is not an option, and needed counts the rare values below it not seen yet
+    int common = 0;
+    while (common < top && (isRare(space, common) || seen[common] == stamp))
+      common++;
+    // with mask 0, the splits above were all of them, and there is nothing left to scan
+    int needed = 0;
+    for (int v = 0; v < common && space.mask != 0; v++)
+      needed += isRare(space, v) && seen[v] != stamp;
+    for (uint64_t a = 1; needed > 0; a++)
+    {
+      bool any = false;
+      for (int k : splits)
+      {
+        if (h < (uint64_t)k + 2 * a)
+          continue;
+        any = true;
+        int v = values[a] ^ values[h - k - a];
+        space.pairs++;
+        if (v < common && seen[v] != stamp && isRare(space, v))
+        {
+          seen[v] = stamp;
+          needed--;
+        }
+      }
+      if (!any)
+      {
+        space.fullScans++;
+        break;
+      }
+    }
+
+    int mex = 0;
+    while (mex < common && seen[mex] == stamp)
+      mex++;
+    if (mex > OCTAL_MAX_VALUE)
+      return h;
+    values[h] = mex;
+    if (reversed != nullptr)
+      reversed[n - h] = mex;
+    space.terms++;
+    if (isRare(space, mex))
+    {
+      space.rare++;
+      if (space.mask != 0)
+        rareTerms.push_back(h);
+    }
+    while (mex >= top)
+      top *= 2;
+    if (seen.size() < (size_t)top + 1)
+      seen.resize(top + 1, 0);
+
+    if (period != nullptr && findPeriod(finder, values, h, *period))
+    {
+      for (uint64_t m = h + 1; m <= n; m++)
+        values[m] = values[m - period->period];
+      return n + 1;
+    }
+  }
+  return n + 1;
+}
+
+// extendOctalSequence(game, n, values, space, period, threads) computes the nimbers of game for heaps 0 through n into values with octalTerms, keeping the nimbers values already holds.
+// while it runs, it takes 4 bytes per term: the uint16_t of values and of the reversed copy the right parts of the splits are read from,
+// as much as an int per term, and 2 bytes per term once it returns. octalTerms on a table without the reversed copy takes only the table.
+// returns false if a nimber is above OCTAL_MAX_VALUE, leaving the terms before it in values.
+// precondition: values holds the nimbers of game for heaps 0 through values.size() - 1
+bool extendOctalSequence(const OctalGame &game, uint64_t n, vector<uint16_t> &values, SparseSpace &space, OctalPeriod *period = nullptr, int threads = 1)
+{
+  uint64_t known = min<uint64_t>(values.size(), n + 1);
+  values.resize(n + 1, 0);
+  vector<uint16_t> reversed(n + 1, 0);
+  values.resize(octalTerms(game, n, values.data(), reversed.data(), known, space, period, threads));
+  return values.size() == n + 1;
+}
+
+// octalSequence(game, n, values, space, period, threads) computes the nimbers of game for heaps 0 through n into values like extendOctalSequence, from heap 0 on
+bool octalSequence(const OctalGame &game, uint64_t n, vector<uint16_t> &values, SparseSpace &space, OctalPeriod *period = nullptr, int threads = 1)
+{
+  values.clear();
+  return extendOctalSequence(game, n, values, space, period, threads);
+}
+
+// jacobsLadderNim(n, values, threads) computes the nimber for the Jacob's Ladder game for all of 0 through n into values with threads threads, and returns the nimber of n
+// precondition: the nimbers up to n are at most OCTAL_MAX_VALUE
+int jacobsLadderNim(uint64_t n, vector<uint16_t> &values, int threads = 1)
+{
+  OctalGame game;
+  parseOctalGame("0.11337", game);
+  SparseSpace space;
+  octalSequence(game, n, values, space, nullptr, threads);
+  return values[n];
+}
+
+#endif
@@ -0,0 +1,32 @@
+// parallel.h holds the loop that splits work across threads, shared by toggle.h and octal.h.
+// code compiled with gcc 10.3, may not be backwards compatible with older versions of c++
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// parallelFor(count, threads, body) calls body(begin, end, thread) on chunks of [0, count) from threads threads, where thread is the index of the calling thread.
+// chunks are handed out as threads ask for them, so uneven chunks do not leave threads idle.
+void parallelFor(size_t count, int threads, const function<void(size_t, size_t, int)> &body)
+{
+  size_t chunk = max<size_t>(1, min<size_t>(4096, count / (8 * threads)));
+  atomic<size_t> next(0);
+  auto worker = [&](int thread)
+  {
+    for (size_t begin = next.fetch_add(chunk); begin < count; begin = next.fetch_add(chunk))
+      body(begin, min(count, begin + chunk), thread);
+  };
+  vector<thread> pool;
+  for (int t = 1; t < threads; t++)
+    pool.emplace_back(worker, t);
+  worker(0);
+  for (int t = 0; t < (int)pool.size(); t++)
+    pool[t].join();
+}
+
+#endif
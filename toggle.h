@@ -0,0 +1,2370 @@
+// toggle.h holds the toggle game engine shared by automation.cpp, main.cpp and togglen2.cpp.
+// every program is a single translation unit, so this header is included exactly once per binary.
+// code compiled with gcc 10.3, may not be backwards compatible with older versions of c++
+#ifndef TOGGLE_H
+#define TOGGLE_H
+
+#include <fstream>
+#include <vector>
+#include <unordered_set>
+#include <unordered_map>
+#include <string>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <iostream>
+#include <mutex>
+#include "parallel.h"
+using namespace std;
+
+// STATE_WORDS is the number of 64-bit words in a game state, so graphs can have up to 64 * STATE_WORDS vertices.
+// build with -DSTATE_WORDS=1 for graphs with at most 64 vertices.
+#ifndef STATE_WORDS
+#define STATE_WORDS 2
+#endif
+const int MAX_VERTICES = 64 * STATE_WORDS;
+
+// State is a game state packed one bit per vertex: vertex i is bit i % 64 of word i / 64, and a set bit means the vertex is a 1.
+struct State
+{
+  uint64_t w[STATE_WORDS];
+};
+
+// emptyState() returns the state with every vertex set to 0
+inline State emptyState()
+{
+  State s;
+  for (int j = 0; j < STATE_WORDS; j++)
+    s.w[j] = 0;
+  return s;
+}
+
+// testBit(s, i) returns whether vertex i is a 1 in s
+inline bool testBit(const State &s, int i)
+{
+  return (s.w[i >> 6] >> (i & 63)) & 1;
+}
+
+// setBit(s, i) sets vertex i of s to 1
+inline void setBit(State &s, int i)
+{
+  s.w[i >> 6] |= uint64_t(1) << (i & 63);
+}
+
+// clearBit(s, i) sets vertex i of s to 0
+inline void clearBit(State &s, int i)
+{
+  s.w[i >> 6] &= ~(uint64_t(1) << (i & 63));
+}
+
+inline State operator^(const State &a, const State &b)
+{
+  State r;
+  for (int j = 0; j < STATE_WORDS; j++)
+    r.w[j] = a.w[j] ^ b.w[j];
+  return r;
+}
+
+inline State operator&(const State &a, const State &b)
+{
+  State r;
+  for (int j = 0; j < STATE_WORDS; j++)
+    r.w[j] = a.w[j] & b.w[j];
+  return r;
+}
+
+inline State operator|(const State &a, const State &b)
+{
+  State r;
+  for (int j = 0; j < STATE_WORDS; j++)
+    r.w[j] = a.w[j] | b.w[j];
+  return r;
+}
+
+inline State operator~(const State &a)
+{
+  State r;
+  for (int j = 0; j < STATE_WORDS; j++)
+    r.w[j] = ~a.w[j];
+  return r;
+}
+
+inline bool operator==(const State &a, const State &b)
+{
+  for (int j = 0; j < STATE_WORDS; j++)
+    if (a.w[j] != b.w[j])
+      return false;
+  return true;
+}
+
+inline bool operator!=(const State &a, const State &b)
+{
+  return !(a == b);
+}
+
+// operator< orders states by their words, highest word first, so sorted states can be binary searched
+inline bool operator<(const State &a, const State &b)
+{
+  for (int j = STATE_WORDS - 1; j >= 0; j--)
+  {
+    if (a.w[j] != b.w[j])
+      return a.w[j] < b.w[j];
+  }
+  return false;
+}
+
+// popcount(s) returns the number of 1's in s
+inline int popcount(const State &s)
+{
+  int count = 0;
+  for (int j = 0; j < STATE_WORDS; j++)
+    count += __builtin_popcountll(s.w[j]);
+  return count;
+}
+
+// StateHash mixes the words of a state so it can key unordered containers
+struct StateHash
+{
+  size_t operator()(const State &s) const
+  {
+    uint64_t h = 0x9e3779b97f4a7c15ULL;
+    for (int j = 0; j < STATE_WORDS; j++)
+    {
+      h ^= s.w[j];
+      h *= 0xbf58476d1ce4e5b9ULL;
+      h ^= h >> 31;
+    }
+    return h;
+  }
+};
+
+// lowBits(len) returns the state with vertices 0 through len - 1 set to 1
+inline State lowBits(int len)
+{
+  State s;
+  for (int j = 0; j < STATE_WORDS; j++)
+  {
+    int bits = len - 64 * j;
+    s.w[j] = bits >= 64 ? ~uint64_t(0) : bits <= 0 ? 0 : (uint64_t(1) << bits) - 1;
+  }
+  return s;
+}
+
+// shiftDown(s, k) moves every vertex i of s to vertex i - k, dropping vertices below 0
+inline State shiftDown(const State &s, int k)
+{
+  State r = emptyState();
+  int words = k >> 6, bits = k & 63;
+  for (int j = 0; j + words < STATE_WORDS; j++)
+  {
+    r.w[j] = s.w[j + words] >> bits;
+    if (bits != 0 && j + words + 1 < STATE_WORDS)
+      r.w[j] |= s.w[j + words + 1] << (64 - bits);
+  }
+  return r;
+}
+
+// shiftUp(s, k) moves every vertex i of s to vertex i + k, dropping vertices past MAX_VERTICES
+inline State shiftUp(const State &s, int k)
+{
+  State r = emptyState();
+  int words = k >> 6, bits = k & 63;
+  for (int j = STATE_WORDS - 1; j - words >= 0; j--)
+  {
+    r.w[j] = s.w[j - words] << bits;
+    if (bits != 0 && j - words - 1 >= 0)
+      r.w[j] |= s.w[j - words - 1] >> (64 - bits);
+  }
+  return r;
+}
+
+// rotateField(s, start, len, r) cyclically moves the vertices start through start + len - 1 of s down by r places, leaving the rest of s alone.
+// precondition: 0 <= r < len
+inline State rotateField(const State &s, int start, int len, int r)
+{
+  State low = lowBits(len);
+  State field = shiftDown(s, start) & low;
+  State rotated = (shiftDown(field, r) | shiftUp(field, len - r)) & low;
+  return (s & ~shiftUp(low, start)) | shiftUp(rotated, start);
+}
+
+// stateFromString(str) packs a string of 0's and 1's into a State, where character i is vertex i
+State stateFromString(const string &str)
+{
+  State s = emptyState();
+  for (int i = 0; i < (int)str.size() && i < MAX_VERTICES; i++)
+  {
+    if (str[i] == '1')
+      setBit(s, i);
+  }
+  return s;
+}
+
+// stateToString(s, n) unpacks the first n vertices of s into a string of 0's and 1's
+string stateToString(const State &s, int n)
+{
+  string str(n, '0');
+  for (int i = 0; i < n; i++)
+  {
+    if (testBit(s, i))
+      str[i] = '1';
+  }
+  return str;
+}
+
+// zobristKeys[i] is the random 64-bit key of vertex i. the key of a state is the XOR of the keys of its 1's,
+// so toggling a vertex changes the key by the XOR of the keys of its closed neighborhood.
+// the keys come from a fixed seed so that keys are the same in every run.
+uint64_t zobristKeys[MAX_VERTICES];
+// zobristBytes[b][v] is the XOR of the keys of the vertices set in byte value v at byte b of a state, so a whole state hashes with one lookup per byte
+uint64_t zobristBytes[MAX_VERTICES / 8][256];
+
+// initZobrist() fills zobristKeys and zobristBytes from a splitmix64 sequence
+const uint64_t ZOBRIST_SEED = 0x5eed70661eULL;
+
+void initZobrist()
+{
+  uint64_t seed = ZOBRIST_SEED;
+  for (int i = 0; i < MAX_VERTICES; i++)
+  {
+    uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    zobristKeys[i] = z ^ (z >> 31);
+  }
+  for (int b = 0; b < MAX_VERTICES / 8; b++)
+  {
+    for (int v = 0; v < 256; v++)
+    {
+      uint64_t key = 0;
+      for (int bit = 0; bit < 8; bit++)
+      {
+        if ((v >> bit) & 1)
+          key ^= zobristKeys[8 * b + bit];
+      }
+      zobristBytes[b][v] = key;
+    }
+  }
+}
+
+// hashState(s) computes the Zobrist key of s from scratch
+inline uint64_t hashState(const State &s)
+{
+  uint64_t key = 0;
+  for (int j = 0; j < STATE_WORDS; j++)
+  {
+    for (int b = 0; b < 8; b++)
+    {
+      key ^= zobristBytes[8 * j + b][(s.w[j] >> (8 * b)) & 255];
+    }
+  }
+  return key;
+}
+
+// NimTable is the memoization table of nimbers: an open-addressing table of 64-byte buckets, each holding eight 8-byte entries.
+// an entry packs the top 48 bits of a state's Zobrist key as its fingerprint, the number of 1's in the state and its nimber, and 0 marks an empty entry.
+// the bucket of a key is picked from its low bits, at least the 16 bits the fingerprint leaves out, so a fingerprint has 64 - log2(bucketCount) bits that its bucket does not decide,
+// still 40 with the 2^24 buckets of a 1 GB table. the bits above the low 16 that pick a bucket are in the fingerprint, so the table can double in place.
+// it doubles once more than TABLE_MAX_LOAD of all its entries are used, until it reaches maxBuckets. storing into a full bucket before then, or at the memory cap,
+// replaces the entry with the fewest 1's, whose subtree is the cheapest to recompute, so a table is never mostly empty buckets.
+const int TABLE_BUCKET_ENTRIES = 8;
+const uint64_t TABLE_MIN_BUCKETS = 1 << 16;
+const double TABLE_MAX_LOAD = 0.75;
+
+struct alignas(64) TableBucket
+{
+  uint64_t entries[TABLE_BUCKET_ENTRIES];
+};
+
+// TableHeader starts a nimber table that lives in a cache file, see openTableFile. the buckets follow it at TABLE_HEADER_BYTES.
+const uint64_t TABLE_FILE_MAGIC = 0x454c4241544d494eULL; // "NIMTABLE"
+const uint64_t TABLE_FILE_VERSION = 2;
+const uint64_t TABLE_HEADER_BYTES = 4096;
+
+struct TableHeader
+{
+  uint64_t magic;
+  uint64_t version;
+  uint64_t graph;       // graphFingerprint of the graph the nimbers belong to
+  uint64_t zobristSeed; // keys are only comparable between runs with the same Zobrist keys
+  uint64_t bucketCount;
+  uint64_t used;
+  uint64_t dirty; // set while a process has the file open, so a crashed run's claims get cleaned up
+};
+
+struct NimTable
+{
+  TableBucket *buckets = nullptr;
+  uint64_t bucketCount = 0;      // always a power of two
+  uint64_t maxBuckets = 0;       // the memory cap in buckets, or 0 for no cap
+  uint64_t used = 0;             // number of non-empty entries
+  uint64_t evictions = 0;        // number of entries replaced because their bucket was full
+  int fd = -1;                   // the cache file holding the table, or -1 if it is in anonymous memory
+  TableHeader *header = nullptr; // start of the mapping of the cache file
+};
+
+// tableMapping(table) returns the start of the memory mapping holding table, and tableMappingBytes(table) its length
+inline char *tableMapping(const NimTable &table)
+{
+  return table.fd < 0 ? (char *)table.buckets : (char *)table.header;
+}
+
+inline uint64_t tableMappingBytes(const NimTable &table)
+{
+  return table.bucketCount * sizeof(TableBucket) + (table.fd < 0 ? 0 : TABLE_HEADER_BYTES);
+}
+
+// mapBuckets(table, count) gives table count buckets, keeping the ones it has and zeroing the new ones.
+// the pages come straight from mmap, so they are cache-line aligned and only use memory once touched, and mremap moves existing pages without copying them.
+// a table in a cache file is grown by extending the file first.
+void mapBuckets(NimTable &table, uint64_t count)
+{
+  uint64_t extra = table.fd < 0 ? 0 : TABLE_HEADER_BYTES;
+  uint64_t bytes = count * sizeof(TableBucket) + extra;
+  void *mem;
+  if (table.fd >= 0 && ftruncate(table.fd, bytes) != 0)
+    mem = MAP_FAILED;
+  else if (table.buckets == nullptr && table.fd < 0)
+    mem = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  else if (table.buckets == nullptr)
+    mem = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, table.fd, 0);
+  else
+    mem = mremap(tableMapping(table), tableMappingBytes(table), bytes, MREMAP_MAYMOVE);
+  if (mem == MAP_FAILED)
+  {
+    cout << "could not allocate " << bytes / (1 << 20) << " MB for the nimber table\n";
+    exit(1);
+  }
+  table.buckets = (TableBucket *)((char *)mem + extra);
+  table.header = table.fd < 0 ? nullptr : (TableHeader *)mem;
+  table.bucketCount = count;
+  if (table.header != nullptr)
+    table.header->bucketCount = count;
+}
+
+// unmapBuckets(table) frees the buckets of table
+void unmapBuckets(NimTable &table)
+{
+  if (table.buckets != nullptr)
+    munmap(tableMapping(table), tableMappingBytes(table));
+  table.buckets = nullptr;
+  table.header = nullptr;
+  table.bucketCount = 0;
+}
+
+void closeTableFile(NimTable &table);
+
+// initTable(table, maxBytes) empties table and caps it at maxBytes of memory, where 0 means no cap. a table in a cache file is closed and replaced by an anonymous one.
+void initTable(NimTable &table, uint64_t maxBytes)
+{
+  closeTableFile(table);
+  unmapBuckets(table);
+  table.maxBuckets = 0;
+  if (maxBytes > 0)
+  {
+    // round the cap down to a power of two number of buckets
+    table.maxBuckets = TABLE_MIN_BUCKETS;
+    while (table.maxBuckets * 2 * sizeof(TableBucket) <= maxBytes)
+      table.maxBuckets *= 2;
+  }
+  mapBuckets(table, TABLE_MIN_BUCKETS);
+  table.used = 0;
+  table.evictions = 0;
+}
+
+// clearTable(table) empties table, keeping its memory cap
+void clearTable(NimTable &table)
+{
+  uint64_t maxBuckets = table.maxBuckets;
+  initTable(table, 0);
+  table.maxBuckets = maxBuckets;
+}
+
+// tableBytes(table) returns the memory used by the buckets of table
+uint64_t tableBytes(const NimTable &table)
+{
+  return table.bucketCount * sizeof(TableBucket);
+}
+
+// fingerprint(key) is the part of a Zobrist key kept in an entry, never 0 so that 0 can mark empty entries
+inline uint64_t fingerprint(uint64_t key)
+{
+  uint64_t fp = key >> 16;
+  return fp == 0 ? 1 : fp;
+}
+
+// keyBucket(table, key) returns the bucket of table that holds the state with Zobrist key key
+inline TableBucket &keyBucket(const NimTable &table, uint64_t key)
+{
+  return table.buckets[key & (table.bucketCount - 1)];
+}
+
+// lookupNimber(table, key, nimber) sets nimber to the stored nimber of the state with Zobrist key key and returns true, or returns false if it is not stored
+inline bool lookupNimber(const NimTable &table, uint64_t key, int &nimber)
+{
+  uint64_t fp = fingerprint(key);
+  const TableBucket &bucket = keyBucket(table, key);
+  for (int e = 0; e < TABLE_BUCKET_ENTRIES; e++)
+  {
+    if ((bucket.entries[e] >> 16) == fp)
+    {
+      nimber = bucket.entries[e] & 255;
+      return true;
+    }
+  }
+  return false;
+}
+
+// growTable(table) doubles the number of buckets of table in place, moving every entry to the bucket picked by one more bit of its key, which is bit log2(bucketCount) of the entry
+void growTable(NimTable &table)
+{
+  uint64_t count = table.bucketCount;
+  mapBuckets(table, 2 * count);
+  for (uint64_t b = 0; b < count; b++)
+  {
+    // the new bucket is b or b + count, and b + count starts empty and gets at most the eight entries of b
+    int filled = 0;
+    for (int e = 0; e < TABLE_BUCKET_ENTRIES; e++)
+    {
+      uint64_t entry = table.buckets[b].entries[e];
+      if ((entry & count) != 0)
+      {
+        table.buckets[b + count].entries[filled++] = entry;
+        table.buckets[b].entries[e] = 0;
+      }
+    }
+  }
+}
+
+// storeNimber(table, key, nimber, ones) stores the nimber of the state with Zobrist key key and ones 1's, growing the table once it is past TABLE_MAX_LOAD and replacing an entry if its bucket is full
+void storeNimber(NimTable &table, uint64_t key, int nimber, int ones)
+{
+  if (table.used >= TABLE_MAX_LOAD * table.bucketCount * TABLE_BUCKET_ENTRIES && (table.maxBuckets == 0 || table.bucketCount < table.maxBuckets))
+    growTable(table);
+  uint64_t fp = fingerprint(key);
+  uint64_t entry = (fp << 16) | (uint64_t(min(ones, 255)) << 8) | uint64_t(nimber);
+  TableBucket &bucket = keyBucket(table, key);
+  int victim = 0;
+  for (int e = 0; e < TABLE_BUCKET_ENTRIES; e++)
+  {
+    if (bucket.entries[e] == 0 || (bucket.entries[e] >> 16) == fp)
+    {
+      table.used += bucket.entries[e] == 0;
+      bucket.entries[e] = entry;
+      return;
+    }
+    if (((bucket.entries[e] >> 8) & 255) < ((bucket.entries[victim] >> 8) & 255))
+      victim = e;
+  }
+  bucket.entries[victim] = entry;
+  table.evictions++;
+}
+
+// the functions below are the thread-safe side of NimTable, used while several threads search at once.
+// every entry is read and written with atomic operations, the table never grows, and a thread claims a state with a CLAIMED_NIMBER entry before solving it, so no two threads solve the same state.
+// claims are never evicted, so a bucket can be full of them; a state in such a bucket cannot be claimed until one of them is published.
+const int CLAIMED_NIMBER = 255;
+
+// ClaimResult is the outcome of claimState
+enum ClaimResult
+{
+  CLAIM_TAKEN, // the calling thread now holds the claim
+  CLAIM_HELD,  // the state is already solved or claimed by another thread
+  CLAIM_BUSY   // every entry of the bucket is a claim on some other state, so nothing was written
+};
+
+// presizeTable(table) grows table to its memory cap at once, since a table shared between threads cannot grow
+void presizeTable(NimTable &table)
+{
+  if (table.used == 0 && table.bucketCount < table.maxBuckets)
+  {
+    // nothing to move, so map the full table directly instead of touching every page while doubling
+    mapBuckets(table, table.maxBuckets);
+  }
+  while (table.bucketCount < table.maxBuckets)
+    growTable(table);
+}
+
+// probeNimber(table, key) returns the nimber stored for key, CLAIMED_NIMBER if a thread is solving it, or -1 if it is not in the table
+inline int probeNimber(const NimTable &table, uint64_t key)
+{
+  uint64_t fp = fingerprint(key);
+  const TableBucket &bucket = keyBucket(table, key);
+  for (int e = 0; e < TABLE_BUCKET_ENTRIES; e++)
+  {
+    uint64_t entry = __atomic_load_n(&bucket.entries[e], __ATOMIC_ACQUIRE);
+    if ((entry >> 16) == fp)
+      return entry & 255;
+  }
+  return -1;
+}
+
+// claimState(table, key, ones) claims the state with Zobrist key key and ones 1's for the calling thread, replacing the solved entry with the fewest 1's if its bucket is full.
+// returns CLAIM_HELD if the state is already solved or claimed, and CLAIM_BUSY without claiming it if its bucket holds nothing but claims.
+ClaimResult claimState(NimTable &table, uint64_t key, int ones)
+{
+  uint64_t fp = fingerprint(key);
+  uint64_t claim = (fp << 16) | (uint64_t(min(ones, 255)) << 8) | CLAIMED_NIMBER;
+  TableBucket &bucket = keyBucket(table, key);
+  while (true)
+  {
+    int victim = -1;
+    uint64_t victimEntry = 0;
+    bool raced = false;
+    for (int e = 0; e < TABLE_BUCKET_ENTRIES && !raced; e++)
+    {
+      uint64_t entry = __atomic_load_n(&bucket.entries[e], __ATOMIC_ACQUIRE);
+      if ((entry >> 16) == fp)
+        return CLAIM_HELD;
+      if (entry == 0)
+      {
+        if (__atomic_compare_exchange_n(&bucket.entries[e], &entry, claim, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+          __atomic_fetch_add(&table.used, 1, __ATOMIC_RELAXED);
+          return CLAIM_TAKEN;
+        }
+        // another thread filled this entry first, so look at the bucket again
+        raced = true;
+      }
+      else if ((entry & 255) != CLAIMED_NIMBER && (victim < 0 || ((entry >> 8) & 255) < ((victimEntry >> 8) & 255)))
+      {
+        victim = e;
+        victimEntry = entry;
+      }
+    }
+    if (raced)
+      continue;
+    if (victim < 0)
+      return CLAIM_BUSY;
+    if (__atomic_compare_exchange_n(&bucket.entries[victim], &victimEntry, claim, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+      __atomic_fetch_add(&table.evictions, 1, __ATOMIC_RELAXED);
+      return CLAIM_TAKEN;
+    }
+  }
+}
+
+// publishNimber(table, key, nimber, ones) replaces the calling thread's claim on key with the nimber it found.
+// a thread that solved key without a claim, after claimState returned CLAIM_BUSY, only keeps the nimber if the bucket has a free entry by now.
+void publishNimber(NimTable &table, uint64_t key, int nimber, int ones)
+{
+  uint64_t fp = fingerprint(key);
+  uint64_t entry = (fp << 16) | (uint64_t(min(ones, 255)) << 8) | uint64_t(nimber);
+  TableBucket &bucket = keyBucket(table, key);
+  for (int e = 0; e < TABLE_BUCKET_ENTRIES; e++)
+  {
+    if ((__atomic_load_n(&bucket.entries[e], __ATOMIC_ACQUIRE) >> 16) == fp)
+    {
+      __atomic_store_n(&bucket.entries[e], entry, __ATOMIC_RELEASE);
+      return;
+    }
+  }
+  // the state was solved without a claim, so only keep it if an entry is free
+  for (int e = 0; e < TABLE_BUCKET_ENTRIES; e++)
+  {
+    uint64_t empty = 0;
+    if (__atomic_compare_exchange_n(&bucket.entries[e], &empty, entry, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+      __atomic_fetch_add(&table.used, 1, __ATOMIC_RELAXED);
+      return;
+    }
+  }
+}
+
+// releaseClaim(table, key) drops the calling thread's claim on key without a nimber, for a search that stops before solving the state
+void releaseClaim(NimTable &table, uint64_t key)
+{
+  uint64_t fp = fingerprint(key);
+  TableBucket &bucket = keyBucket(table, key);
+  for (int e = 0; e < TABLE_BUCKET_ENTRIES; e++)
+  {
+    uint64_t entry = __atomic_load_n(&bucket.entries[e], __ATOMIC_ACQUIRE);
+    if ((entry >> 16) == fp && (entry & 255) == CLAIMED_NIMBER &&
+        __atomic_compare_exchange_n(&bucket.entries[e], &entry, 0, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+      __atomic_fetch_sub(&table.used, 1, __ATOMIC_RELAXED);
+      return;
+    }
+  }
+}
+
+// the functions below keep a nimber table in a cache file, so that a later run on the same graph starts from the nimbers of earlier ones.
+// the file is the table itself, a TableHeader and then the buckets, mapped with MAP_SHARED: opening it is instant, the OS pages in only the buckets that are touched, and new nimbers reach the file as pages are written back.
+// a file whose header does not match the graph is started over.
+
+// openTableFile(table, path, graph) puts table in the cache file at path for the graph with fingerprint graph, keeping table's memory cap.
+// returns true if the file already held nimbers of this graph. if the file is in use by another process, table stays as it is and false is returned.
+bool openTableFile(NimTable &table, const string &path, uint64_t graph)
+{
+  int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd < 0 || flock(fd, LOCK_EX | LOCK_NB) != 0)
+  {
+    cout << "could not open the cache file " << path << ", running without it\n";
+    if (fd >= 0)
+      close(fd);
+    return false;
+  }
+
+  TableHeader old = {};
+  struct stat info;
+  bool reused = fstat(fd, &info) == 0 && pread(fd, &old, sizeof(old), 0) == (ssize_t)sizeof(old) && old.magic == TABLE_FILE_MAGIC &&
+                old.version == TABLE_FILE_VERSION && old.graph == graph && old.zobristSeed == ZOBRIST_SEED &&
+                old.bucketCount >= TABLE_MIN_BUCKETS && (old.bucketCount & (old.bucketCount - 1)) == 0 &&
+                (uint64_t)info.st_size >= TABLE_HEADER_BYTES + old.bucketCount * sizeof(TableBucket);
+  closeTableFile(table);
+  unmapBuckets(table);
+  table.fd = fd;
+  table.evictions = 0;
+  if (!reused && ftruncate(fd, 0) != 0)
+    cout << "could not clear the cache file " << path << "\n";
+  mapBuckets(table, reused ? old.bucketCount : TABLE_MIN_BUCKETS);
+  if (table.maxBuckets != 0 && table.maxBuckets < table.bucketCount)
+    table.maxBuckets = table.bucketCount;
+
+  TableHeader &header = *table.header;
+  header.magic = TABLE_FILE_MAGIC;
+  header.version = TABLE_FILE_VERSION;
+  header.graph = graph;
+  header.zobristSeed = ZOBRIST_SEED;
+  table.used = reused ? old.used : 0;
+  if (reused && old.dirty != 0)
+  {
+    // the last run did not close the file, so drop the claims of threads that never published and recount the entries
+    table.used = 0;
+    for (uint64_t b = 0; b < table.bucketCount; b++)
+    {
+      for (int e = 0; e < TABLE_BUCKET_ENTRIES; e++)
+      {
+        uint64_t &entry = table.buckets[b].entries[e];
+        if (entry != 0 && (entry & 255) == CLAIMED_NIMBER)
+          entry = 0;
+        table.used += entry != 0;
+      }
+    }
+  }
+  header.used = table.used;
+  header.dirty = 1;
+  return reused;
+}
+
+// syncTableFile(table, wait) writes the nimbers of a table in a cache file back to the file, blocking until they are on disk if wait is set
+void syncTableFile(NimTable &table, bool wait)
+{
+  if (table.fd < 0)
+    return;
+  table.header->used = table.used;
+  msync(tableMapping(table), tableMappingBytes(table), wait ? MS_SYNC : MS_ASYNC);
+}
+
+// closeTableFile(table) writes a table in a cache file back to the file and leaves it with no buckets. other tables are left alone.
+void closeTableFile(NimTable &table)
+{
+  if (table.fd < 0)
+    return;
+  table.header->dirty = 0;
+  syncTableFile(table, true);
+  unmapBuckets(table);
+  close(table.fd);
+  table.fd = -1;
+}
+
+// the functions below write a nimber table to a checkpoint file and read it back, so that a search that is stopped can resume without redoing the positions it solved.
+// a checkpoint only holds the non-empty entries, each as its whole key and its number of 1's and nimber: an entry and the low 16 bits of its bucket give back the key, so entries can be put back into a table of any size.
+// every entry is correct on its own, so a checkpoint taken while threads are still searching is consistent as long as claims are left out.
+const uint64_t CHECKPOINT_MAGIC = 0x54504b434d494eULL; // "NIMCKPT"
+const uint64_t CHECKPOINT_VERSION = 2;
+
+// CheckpointHeader starts a checkpoint file, followed by its entries
+struct CheckpointHeader
+{
+  uint64_t magic;
+  uint64_t version;
+  uint64_t graph;       // graphFingerprint of the graph the nimbers belong to
+  uint64_t zobristSeed; // keys are only comparable between runs with the same Zobrist keys
+  State root;           // start state of the search that wrote the checkpoint
+  double seconds;       // time spent searching before the checkpoint, over every run it resumed from
+  uint64_t outcomes;    // 1 if the entries hold outcomes of runOutcome and not nimbers
+  uint64_t entries;     // number of entries after the header, two words each: the key, and the number of 1's times 256 plus the nimber
+};
+
+// writeCheckpoint(table, path, graph, root, seconds, outcomes) writes the entries of table to the checkpoint file at path for the search of root in the graph with fingerprint graph, where outcomes says whether table is outcomeComps.
+// the file is written next to path and renamed over it once it is on disk, so path always holds a complete checkpoint. other threads may keep searching meanwhile.
+// returns false if the file could not be written, leaving the old checkpoint in place.
+bool writeCheckpoint(const NimTable &table, const string &path, uint64_t graph, const State &root, double seconds, bool outcomes)
+{
+  string temp = path + ".tmp";
+  FILE *file = fopen(temp.c_str(), "wb");
+  if (file == nullptr)
+    return false;
+  CheckpointHeader header = {CHECKPOINT_MAGIC, CHECKPOINT_VERSION, graph, ZOBRIST_SEED, root, seconds, outcomes, 0};
+  bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+  vector<uint64_t> buffer;
+  buffer.reserve(1 << 16);
+  for (uint64_t b = 0; b < table.bucketCount && ok; b++)
+  {
+    for (int e = 0; e < TABLE_BUCKET_ENTRIES; e++)
+    {
+      uint64_t entry = __atomic_load_n(&table.buckets[b].entries[e], __ATOMIC_RELAXED);
+      if (entry != 0 && (entry & 255) != CLAIMED_NIMBER)
+      {
+        buffer.push_back((entry & ~uint64_t(0xffff)) | (b & 0xffff));
+        buffer.push_back(entry & 0xffff);
+      }
+    }
+    if (buffer.size() + 2 * TABLE_BUCKET_ENTRIES > buffer.capacity() || b + 1 == table.bucketCount)
+    {
+      ok = fwrite(buffer.data(), sizeof(uint64_t), buffer.size(), file) == buffer.size();
+      header.entries += buffer.size() / 2;
+      buffer.clear();
+    }
+  }
+  ok = ok && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1 && fflush(file) == 0 && fsync(fileno(file)) == 0;
+  ok = fclose(file) == 0 && ok;
+  if (ok && rename(temp.c_str(), path.c_str()) == 0)
+    return true;
+  remove(temp.c_str());
+  return false;
+}
+
+// readCheckpoint(table, path, graph, root, seconds, outcomes) stores the entries of the checkpoint file at path in table, if it belongs to the graph with fingerprint graph and holds outcomes exactly when outcomes is set.
+// root and seconds are set to the start state and search time recorded in it. returns the number of entries read, or -1 if there is no usable checkpoint.
+int64_t readCheckpoint(NimTable &table, const string &path, uint64_t graph, State &root, double &seconds, bool outcomes)
+{
+  FILE *file = fopen(path.c_str(), "rb");
+  if (file == nullptr)
+    return -1;
+  CheckpointHeader header;
+  if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != CHECKPOINT_MAGIC || header.version != CHECKPOINT_VERSION ||
+      header.graph != graph || header.zobristSeed != ZOBRIST_SEED || header.outcomes != (uint64_t)outcomes)
+  {
+    fclose(file);
+    return -1;
+  }
+  vector<uint64_t> buffer(1 << 16);
+  uint64_t read = 0;
+  for (size_t got; read < header.entries && (got = fread(buffer.data(), 2 * sizeof(uint64_t), buffer.size() / 2, file)) > 0; read += got)
+  {
+    for (size_t i = 0; i < got; i++)
+      storeNimber(table, buffer[2 * i], buffer[2 * i + 1] & 255, (buffer[2 * i + 1] >> 8) & 255);
+  }
+  fclose(file);
+  root = header.root;
+  seconds = header.seconds;
+  return read;
+}
+
+vector<unordered_set<int>> adjMatrix;
+NimTable nimberComps;
+
+// adjStart and adjList hold adjMatrix in compressed sparse row form: the neighbors of i are adjList[adjStart[i]] through adjList[adjStart[i + 1] - 1], in increasing order
+vector<int> adjStart;
+vector<int> adjList;
+// nbhdMasks[i] is the closed neighborhood of vertex i (i and all of its neighbors), so toggling i is an XOR with it
+vector<State> nbhdMasks;
+// nbhdZobrist[i] is the XOR of the Zobrist keys of the closed neighborhood of i, so toggling i changes a state's key by it
+vector<uint64_t> nbhdZobrist;
+// nbhdSize[i] is the number of vertices in the closed neighborhood of i, i.e. its degree plus one
+vector<int> nbhdSize;
+// twinOf[i] is the lowest vertex with the same closed neighborhood as i, and twinMask holds the vertices i with twinOf[i] != i. toggling twins gives the same child.
+vector<int> twinOf;
+State twinMask;
+// numVertices is the number of vertices in the current graph
+int numVertices = 0;
+
+// the builder of a graph declares automorphisms of it, and states are stored and looked up as canonicalState of their orbit, since automorphic positions have the same nimber.
+// symRings is a set of disjoint cycles of vertices that one generator rotates together, each by its own step: rotating moves the 1 at vertex start + i + step to start + i.
+// symRotations is the order of that rotation, and symMaps are the other automorphisms as vertex maps, each tried before every rotation.
+// between them, the rotations and the maps have to cover a group of automorphisms for canonicalState to pick one state per orbit.
+struct SymRing
+{
+  int start; // first vertex of the cycle
+  int len;   // number of vertices in the cycle
+  int step;  // places the cycle turns per rotation
+};
+vector<SymRing> symRings;
+int symRotations = 1;
+vector<vector<int>> symMaps;
+
+// clearSymmetry() forgets the automorphisms of the previous graph. every graph builder calls this before declaring its own.
+void clearSymmetry()
+{
+  symRings = vector<SymRing>();
+  symRotations = 1;
+  symMaps = vector<vector<int>>();
+}
+
+// hasSymmetry() returns whether the current graph has any declared automorphisms
+inline bool hasSymmetry()
+{
+  return symRotations > 1 || !symMaps.empty();
+}
+
+// applyMap(map, s) moves the 1 at each vertex v of s to map[v]
+inline State applyMap(const vector<int> &map, const State &s)
+{
+  State r = emptyState();
+  for (int j = 0; j < STATE_WORDS; j++)
+  {
+    for (uint64_t word = s.w[j]; word != 0; word &= word - 1)
+      setBit(r, map[64 * j + __builtin_ctzll(word)]);
+  }
+  return r;
+}
+
+// rotateRings(s) applies the rotation generator to s, turning every ring with word-level shifts
+inline State rotateRings(State s)
+{
+  for (int r = 0; r < (int)symRings.size(); r++)
+    s = rotateField(s, symRings[r].start, symRings[r].len, symRings[r].step);
+  return s;
+}
+
+// canonicalState(s) returns the smallest state, by operator<, among the images of s under every declared map followed by every rotation
+State canonicalState(const State &s)
+{
+  State best = s;
+  for (int m = -1; m < (int)symMaps.size(); m++)
+  {
+    State image = m < 0 ? s : applyMap(symMaps[m], s);
+    for (int r = 0; r < symRotations; r++)
+    {
+      if (image < best)
+        best = image;
+      if (r + 1 < symRotations)
+        image = rotateRings(image);
+    }
+  }
+  return best;
+}
+
+// memoKey(s, key) returns the key s is stored under in the nimber table, given that its own Zobrist key is key
+inline uint64_t memoKey(const State &s, uint64_t key)
+{
+  return hasSymmetry() ? hashState(canonicalState(s)) : key;
+}
+
+// isAutomorphism(map) returns whether map is a permutation of the vertices that sends edges to edges, using nbhdMasks
+bool isAutomorphism(const vector<int> &map)
+{
+  if ((int)map.size() != numVertices)
+    return false;
+  vector<bool> hit(numVertices, false);
+  for (int i = 0; i < numVertices; i++)
+  {
+    if (map[i] < 0 || map[i] >= numVertices || hit[map[i]] || nbhdSize[i] != nbhdSize[map[i]])
+      return false;
+    hit[map[i]] = true;
+  }
+  for (int i = 0; i < numVertices; i++)
+  {
+    for (int j = adjStart[i]; j < adjStart[i + 1]; j++)
+    {
+      if (!testBit(nbhdMasks[map[i]], map[adjList[j]]))
+        return false;
+    }
+  }
+  return true;
+}
+
+// verifySymmetry() drops every declared automorphism that does not preserve the graph, so a wrong declaration can never give a wrong nimber
+void verifySymmetry()
+{
+  if (symRotations > 1)
+  {
+    vector<int> rotation(numVertices);
+    for (int i = 0; i < numVertices; i++)
+      rotation[i] = i;
+    for (int r = 0; r < (int)symRings.size(); r++)
+    {
+      for (int i = 0; i < symRings[r].len; i++)
+        rotation[symRings[r].start + i] = symRings[r].start + (i + symRings[r].len - symRings[r].step) % symRings[r].len;
+    }
+    if (!isAutomorphism(rotation))
+    {
+      cerr << "declared rotation is not an automorphism, ignoring it\n";
+      symRings = vector<SymRing>();
+      symRotations = 1;
+    }
+  }
+  vector<vector<int>> maps;
+  for (int m = 0; m < (int)symMaps.size(); m++)
+  {
+    if (isAutomorphism(symMaps[m]))
+      maps.push_back(symMaps[m]);
+    else
+      cerr << "declared map " << m << " is not an automorphism, ignoring it\n";
+  }
+  symMaps = maps;
+}
+
+// buildGraphArrays() recomputes numVertices, the CSR adjacency, nbhdMasks, nbhdSize and the twins from adjMatrix and checks the declared symmetry. every graph builder calls this once adjMatrix is filled.
+void buildGraphArrays()
+{
+  numVertices = adjMatrix.size();
+  if (numVertices > MAX_VERTICES)
+  {
+    cout << "graph has " << numVertices << " vertices, but states hold at most " << MAX_VERTICES << "; rebuild with a larger STATE_WORDS\n";
+    exit(1);
+  }
+  adjStart = vector<int>(1, 0);
+  adjList = vector<int>();
+  nbhdMasks = vector<State>(numVertices, emptyState());
+  nbhdSize = vector<int>(numVertices);
+  nbhdZobrist = vector<uint64_t>(numVertices);
+  if (zobristKeys[0] == 0)
+    initZobrist();
+  for (int i = 0; i < numVertices; i++)
+  {
+    vector<int> adjs(adjMatrix[i].begin(), adjMatrix[i].end());
+    sort(adjs.begin(), adjs.end());
+    setBit(nbhdMasks[i], i);
+    for (int j = 0; j < (int)adjs.size(); j++)
+    {
+      adjList.push_back(adjs[j]);
+      setBit(nbhdMasks[i], adjs[j]);
+    }
+    adjStart.push_back(adjList.size());
+    nbhdSize[i] = popcount(nbhdMasks[i]);
+    nbhdZobrist[i] = hashState(nbhdMasks[i]);
+  }
+  twinOf = vector<int>(numVertices);
+  twinMask = emptyState();
+  for (int i = 0; i < numVertices; i++)
+  {
+    twinOf[i] = i;
+    for (int j = 0; j < i && twinOf[i] == i; j++)
+    {
+      if (nbhdMasks[j] == nbhdMasks[i])
+        twinOf[i] = j;
+    }
+    if (twinOf[i] != i)
+      setBit(twinMask, i);
+  }
+  verifySymmetry();
+  if (nimberComps.buckets == nullptr)
+    initTable(nimberComps, 0);
+}
+
+// graphFingerprint() returns a hash of the current graph as labeled, which names its cache file. the nimber table hashes states by vertex label, so relabeled copies of a graph get their own files.
+uint64_t graphFingerprint()
+{
+  uint64_t hash = 0xcbf29ce484222325ULL ^ uint64_t(numVertices);
+  for (int i = 0; i < (int)adjList.size(); i++)
+    hash = (hash ^ uint64_t(adjList[i])) * 0x100000001b3ULL;
+  for (int i = 0; i < (int)adjStart.size(); i++)
+    hash = (hash ^ uint64_t(adjStart[i])) * 0x100000001b3ULL;
+  return hash;
+}
+
+// SYM_GROUP_CAP bounds how many automorphisms findAutomorphisms keeps, since canonicalState applies each of them to every state it sees.
+// keeping only part of the group is still sound, every state is just stored under the image of one of the automorphisms it was tried with.
+const int SYM_GROUP_CAP = 256;
+
+// refineColors(a, b) refines the vertex colorings a and b together until they are equitable, coloring each vertex by its color and the colors of its neighbors.
+// new colors are numbered in the sorted order of these signatures, so isomorphic colorings stay isomorphic. returns false as soon as a and b stop having the same signatures.
+bool refineColors(vector<int> &a, vector<int> &b)
+{
+  int colors = 0;
+  while (true)
+  {
+    vector<vector<int>> sigA(numVertices), sigB(numVertices);
+    for (int v = 0; v < numVertices; v++)
+    {
+      for (int j = adjStart[v]; j < adjStart[v + 1]; j++)
+      {
+        sigA[v].push_back(a[adjList[j]]);
+        sigB[v].push_back(b[adjList[j]]);
+      }
+      sort(sigA[v].begin(), sigA[v].end());
+      sort(sigB[v].begin(), sigB[v].end());
+      sigA[v].insert(sigA[v].begin(), a[v]);
+      sigB[v].insert(sigB[v].begin(), b[v]);
+    }
+    vector<vector<int>> sortedA = sigA, sortedB = sigB;
+    sort(sortedA.begin(), sortedA.end());
+    sort(sortedB.begin(), sortedB.end());
+    if (sortedA != sortedB)
+      return false;
+    sortedA.erase(unique(sortedA.begin(), sortedA.end()), sortedA.end());
+    for (int v = 0; v < numVertices; v++)
+    {
+      a[v] = lower_bound(sortedA.begin(), sortedA.end(), sigA[v]) - sortedA.begin();
+      b[v] = lower_bound(sortedA.begin(), sortedA.end(), sigB[v]) - sortedA.begin();
+    }
+    if ((int)sortedA.size() == colors)
+      return true;
+    colors = sortedA.size();
+  }
+}
+
+// splitCell(colors) returns the smallest color shared by more than one vertex, or -1 if every vertex has its own color
+int splitCell(const vector<int> &colors)
+{
+  vector<int> count(numVertices, 0);
+  for (int v = 0; v < numVertices; v++)
+    count[colors[v]]++;
+  for (int c = 0; c < numVertices; c++)
+  {
+    if (count[c] > 1)
+      return c;
+  }
+  return -1;
+}
+
+// matchColorings(a, b, map) searches for an automorphism taking the coloring a to the coloring b, individualizing a vertex of a and trying every vertex of b in its place.
+// returns true and sets map if one exists.
+bool matchColorings(vector<int> a, vector<int> b, vector<int> &map)
+{
+  if (!refineColors(a, b))
+    return false;
+  int cell = splitCell(a);
+  if (cell < 0)
+  {
+    vector<int> vertexOf(numVertices);
+    for (int v = 0; v < numVertices; v++)
+      vertexOf[b[v]] = v;
+    map = vector<int>(numVertices);
+    for (int v = 0; v < numVertices; v++)
+      map[v] = vertexOf[a[v]];
+    return isAutomorphism(map);
+  }
+  int base = find(a.begin(), a.end(), cell) - a.begin();
+  a[base] = numVertices;
+  for (int w = 0; w < numVertices; w++)
+  {
+    if (b[w] != cell)
+      continue;
+    vector<int> image = b;
+    image[w] = numVertices;
+    if (matchColorings(a, image, map))
+      return true;
+  }
+  return false;
+}
+
+// findAutomorphisms() computes the automorphism group of the current graph and stores it in symMaps, for graphs that come without declared symmetry.
+// it walks a stabilizer chain: at each level it fixes one more base vertex by partition refinement and finds an automorphism taking the base vertex to each other vertex of its cell.
+// the group is every product of one such coset representative per level, and at most SYM_GROUP_CAP of them are kept.
+void findAutomorphisms()
+{
+  vector<int> colors(numVertices, 0), same(numVertices, 0);
+  if (numVertices == 0 || !refineColors(colors, same))
+    return;
+  vector<vector<vector<int>>> levels;
+  for (int cell = splitCell(colors); cell >= 0; cell = splitCell(colors))
+  {
+    int base = find(colors.begin(), colors.end(), cell) - colors.begin();
+    vector<vector<int>> representatives;
+    vector<int> fixed = colors;
+    fixed[base] = numVertices;
+    for (int w = 0; w < numVertices; w++)
+    {
+      vector<int> map;
+      vector<int> image = colors;
+      image[w] = numVertices;
+      if (w != base && colors[w] == cell && matchColorings(fixed, image, map))
+        representatives.push_back(map);
+    }
+    levels.push_back(representatives);
+    same = fixed;
+    colors = fixed;
+    refineColors(colors, same);
+  }
+
+  vector<vector<int>> group(1, vector<int>(numVertices));
+  for (int v = 0; v < numVertices; v++)
+    group[0][v] = v;
+  for (int l = levels.size() - 1; l >= 0; l--)
+  {
+    int size = group.size();
+    for (int t = 0; t < (int)levels[l].size() && (int)group.size() < SYM_GROUP_CAP + 1; t++)
+    {
+      for (int g = 0; g < size && (int)group.size() < SYM_GROUP_CAP + 1; g++)
+      {
+        vector<int> product(numVertices);
+        for (int v = 0; v < numVertices; v++)
+          product[v] = levels[l][t][group[g][v]];
+        group.push_back(product);
+      }
+    }
+  }
+  symMaps = vector<vector<int>>(group.begin() + 1, group.end());
+}
+
+// createAdjs(n, inLines) creates the graph from the adjacency matrix, where inLines is a list of binary strings corresponding to each vertex in order and n is the number of vertices. This will wipe adjMatrix and fill it with the adjacencies in this graph.
+// the graph declares no symmetry of its own, so its automorphisms are found with findAutomorphisms.
+void createAdjs(int n, vector<string> inLines)
+{
+  adjMatrix = vector<unordered_set<int>>();
+  clearSymmetry();
+  for (int i = 0; i < n; i++)
+  {
+    unordered_set<int> iAdjs;
+    for (int j = 0; j < n; j++)
+    {
+      if (inLines[i][j] == '1')
+      {
+        iAdjs.insert(j);
+      }
+    }
+    adjMatrix.push_back(iAdjs);
+  }
+  buildGraphArrays();
+  findAutomorphisms();
+}
+
+// createGPetersenAdjs(n, k) will wipe adjMatrix, create the adjacencies for the generalized Petersen graph GP(n, k) and store them in adjMatrix.
+void createGPetersenAdjs(int n, int k)
+{
+  adjMatrix = vector<unordered_set<int>>();
+  clearSymmetry();
+  for (int j = 0; j < 2 * n; j++)
+  {
+    if (j < n)
+    {
+      adjMatrix.push_back(unordered_set<int>({(j + n - 1) % n, (j + 1) % n, j + n}));
+    }
+    else
+    {
+      adjMatrix.push_back(unordered_set<int>({j - n, (j + n - k) % n + n, (j + k) % n + n}));
+    }
+  }
+
+  // symmetry: rotating both cycles, reflecting both cycles, and when k^2 = +-1 (mod n), swapping the cycles with outer i <-> inner k * i
+  symRings = {{0, n, 1}, {n, n, 1}};
+  symRotations = n;
+  vector<int> reflection(2 * n), swap(2 * n), swapReflection(2 * n);
+  for (int i = 0; i < n; i++)
+  {
+    reflection[i] = (n - i) % n;
+    reflection[n + i] = n + (n - i) % n;
+    swap[i] = n + (k * i) % n;
+    swap[n + i] = (k * i) % n;
+  }
+  for (int i = 0; i < 2 * n; i++)
+    swapReflection[i] = swap[reflection[i]];
+  symMaps.push_back(reflection);
+  if ((k * k) % n == 1 || (k * k) % n == n - 1)
+  {
+    symMaps.push_back(swap);
+    symMaps.push_back(swapReflection);
+  }
+  buildGraphArrays();
+  return;
+}
+
+// createSubdivG1Adjs will wipe adjMatrix, create the adjacencies for GP(n, 1), but subdivide the outer cycle with k - 1 vertices between each pair of outer vertices
+void createSubdivG1Adjs(int n, int k)
+{
+  adjMatrix = vector<unordered_set<int>>();
+  clearSymmetry();
+  int w = n * k;
+  for (int j = 0; j < w + n; j++)
+  {
+    unordered_set<int> adjs = unordered_set<int>();
+    if (j < w) // subdivided outer cycle
+    {
+      adjs.insert((j + 1) % w);     // right neighbor
+      adjs.insert((j + w - 1) % w); // left neighbor
+      if (j % k == 0)               // should connect to the inside
+      {
+        adjs.insert(w + j / k);
+      }
+    }
+    else // normal inner cycle
+    {
+      adjs.insert((j - w) * k);             // outside cycle connection
+      adjs.insert(w + (j - w + 1) % n);     // right neighbor
+      adjs.insert(w + (j - w + n - 1) % n); // left neighbor
+    }
+    adjMatrix.push_back(adjs);
+  }
+
+  // symmetry: rotating the outer cycle by k while the inner cycle turns by one, and reflecting both cycles
+  symRings = {{0, w, k}, {w, n, 1}};
+  symRotations = n;
+  vector<int> reflection(w + n);
+  for (int j = 0; j < w; j++)
+    reflection[j] = (w - j) % w;
+  for (int i = 0; i < n; i++)
+    reflection[w + i] = w + (n - i) % n;
+  symMaps.push_back(reflection);
+  buildGraphArrays();
+  return;
+}
+
+// createGridAdjs(h, w) will wipe adjMatrix, create the adjacencies for an h x w grid and store them in adjMatrix.
+void createGridAdjs(int h, int w)
+{
+  adjMatrix = vector<unordered_set<int>>();
+  clearSymmetry();
+  for (int k = 0; k < h * w; k++)
+  {
+    unordered_set<int> adjs = unordered_set<int>();
+    // r is the row of position k, indexed from 0
+    int r = k / w;
+    // c is the column of position k, indexed from 0
+    int c = k % w;
+
+    if (r != 0)
+      adjs.insert(k - w);
+    if (r < h - 1)
+      adjs.insert(k + w);
+    if (c != 0)
+      adjs.insert(k - 1);
+    if (c < w - 1)
+      adjs.insert(k + 1);
+
+    adjMatrix.push_back(adjs);
+  }
+
+  // symmetry: the reflections of the rectangle, plus the diagonal reflections and quarter turns of a square
+  for (int m = 1; m < (h == w ? 8 : 4); m++)
+  {
+    vector<int> map(h * w);
+    for (int k = 0; k < h * w; k++)
+    {
+      int r = k / w, c = k % w;
+      int mr = (m & 1) ? h - 1 - r : r; // flip top to bottom
+      int mc = (m & 2) ? w - 1 - c : c; // flip left to right
+      map[k] = (m & 4) ? mc * w + mr : mr * w + mc;
+    }
+    symMaps.push_back(map);
+  }
+  buildGraphArrays();
+  return;
+}
+
+// createLadderTwistAdjs(w, k) will wipe adjMatrix, create the adjacencies for a "twisted ladder" grid of size 2 x w, where the top row is linked as usual, and every kth vertex is connected on the bottom row.
+// Precondition: w >= 3, k < w / 2
+void createLadderTwistAdjs(int w, int k)
+{
+  adjMatrix = vector<unordered_set<int>>();
+  clearSymmetry();
+  for (int j = 0; j < 2 * w; j++)
+  {
+
+    if (j == 0)
+    {
+      adjMatrix.push_back({1, w});
+    }
+    else if (j == w)
+    {
+      adjMatrix.push_back({0, w + k});
+    }
+    else if (j == w - 1)
+    {
+      adjMatrix.push_back({w - 2, 2 * w - 1});
+    }
+    else if (j == 2 * w - 1)
+    {
+      adjMatrix.push_back({w - 1, 2 * w - k - 1});
+    }
+    else if (j < w)
+    {
+      adjMatrix.push_back({j - 1, j + 1, j + w});
+    }
+    else if (j - w < k)
+    {
+      adjMatrix.push_back({(j + w - k - 1) % w + w, (j + k) % w + w, j - w});
+    }
+    else if (2 * w - j <= k)
+    {
+      adjMatrix.push_back({(j + w - k) % w + w, (j + k + 1) % w + w, j - w});
+    }
+    else
+    {
+      adjMatrix.push_back({(j + w - k) % w + w, (j + k) % w + w, j - w});
+    }
+  }
+
+  // symmetry: reading both rows from the other end
+  vector<int> reflection(2 * w);
+  for (int j = 0; j < w; j++)
+  {
+    reflection[j] = w - 1 - j;
+    reflection[w + j] = 2 * w - 1 - j;
+  }
+  symMaps.push_back(reflection);
+  buildGraphArrays();
+  return;
+}
+
+// printSet(states, count) prints the first count states within curly braces, separated by commas
+void printSet(const State *states, int count)
+{
+  cout << "{";
+  for (int i = 0; i < count; i++)
+  {
+    cout << stateToString(states[i], numVertices) << ", ";
+  }
+  cout << "}\n";
+}
+
+// printAdjs() prints the adjacencies in adjMatrix nicely.
+void printAdjs()
+{
+  for (int i = 0; i < numVertices; i++)
+  {
+    cout << i << ": ";
+    cout << "{";
+    for (int j = adjStart[i]; j < adjStart[i + 1]; j++)
+    {
+      cout << adjList[j] << ", ";
+    }
+    cout << "}\n";
+  }
+}
+
+// toggle(gameState, place) toggles the state of place and all of its neighbors.
+// precondition: place must be between 0 and numVertices - 1 inclusive.
+inline State toggle(const State &gameState, int place)
+{
+  return gameState ^ nbhdMasks[place];
+}
+
+// legalMoves(gameState) returns the set of vertices that can be toggled from gameState, computed for the whole position in one pass.
+// RULE: the number of 1's must STRICTLY decrease, and we can only toggle 1's.
+// toggling i turns the 1's of its closed neighborhood off and the rest on, so i is legal exactly when it is a 1 and more than half of its closed neighborhood is on.
+// the loop body has no branches, so each word of the result is built from independent popcounts that the compiler can vectorize.
+State legalMoves(const State &gameState)
+{
+  State legal = emptyState();
+  for (int j = 0; j < STATE_WORDS; j++)
+  {
+    int first = 64 * j;
+    int last = min(numVertices, first + 64);
+    uint64_t word = 0;
+    for (int i = first; i < last; i++)
+    {
+      int onCounter = popcount(gameState & nbhdMasks[i]);
+      word |= uint64_t(2 * onCounter > nbhdSize[i]) << (i - first);
+    }
+    legal.w[j] = word & gameState.w[j];
+  }
+  return legal;
+}
+
+// distinctMoves(gameState) returns the legal moves of gameState, leaving out every move whose lower twin is also legal, so that no two moves give the same child.
+// twins have the same closed neighborhood, so they are legal together whenever both are 1's.
+inline State distinctMoves(const State &gameState)
+{
+  State legal = legalMoves(gameState);
+  State twins = legal & twinMask;
+  for (int j = 0; j < STATE_WORDS; j++)
+  {
+    for (uint64_t word = twins.w[j]; word != 0; word &= word - 1)
+    {
+      int place = 64 * j + __builtin_ctzll(word);
+      if (testBit(legal, twinOf[place]))
+        clearBit(legal, place);
+    }
+  }
+  return legal;
+}
+
+// getNextStates(gameState, nextStates) writes all valid next states that the game can progress to from the current state, gameState, to nextStates, each once, and returns how many there are.
+// nextStates is owned by the caller and must have room for numVertices states, so generating moves never allocates.
+int getNextStates(const State &gameState, State *nextStates)
+{
+  int count = 0;
+  State moves = distinctMoves(gameState);
+  for (int j = 0; j < STATE_WORDS; j++)
+  {
+    for (uint64_t word = moves.w[j]; word != 0; word &= word - 1)
+    {
+      nextStates[count++] = toggle(gameState, 64 * j + __builtin_ctzll(word));
+    }
+  }
+  return count;
+}
+
+// firstUnset(s) returns the lowest vertex that is 0 in s, or MAX_VERTICES if there is none
+inline int firstUnset(const State &s)
+{
+  for (int j = 0; j < STATE_WORDS; j++)
+  {
+    if (~s.w[j] != 0)
+      return 64 * j + __builtin_ctzll(~s.w[j]);
+  }
+  return MAX_VERTICES;
+}
+
+// mex(seen) computes the minimum excluded natural number of the set of numbers whose bits are set in seen
+inline int mex(const State &seen)
+{
+  return firstUnset(seen);
+}
+
+// SearchFrame is one position on the explicit stack of runGame.
+// a position has at most numVertices children, so its nimber is below MAX_VERTICES and the nimbers of its children fit in a State-sized bitset.
+struct SearchFrame
+{
+  State state;     // the position being solved
+  State movesLeft; // legal moves of state whose children have not been visited yet
+  State seen;      // bit v is set when some child has nimber v
+  State deferred;  // moves whose child another thread is solving, only used by runGameParallel
+  State crowded;   // moves whose child could not be claimed because its bucket was full of claims, only used by runGameParallel
+  uint64_t key;    // Zobrist key of state
+  uint64_t memo;   // key of state in the nimber table, see memoKey
+  bool split;      // state is a sum of independent regions, see splitFrame
+  bool claimed;    // the calling thread holds the claim on state, only used by runGameParallel
+  int parts;       // regions of a split state still waiting on top of regionParts
+  int sum;         // XOR of the nimbers of the regions solved so far
+};
+
+// searchStack holds the frames of runGame. every move turns off at least one 1, so the stack never holds more than numVertices + 1 frames.
+vector<SearchFrame> searchStack;
+
+// SearchProgress describes a running search to searchHook
+struct SearchProgress
+{
+  uint64_t expanded; // number of positions expanded so far, by all threads
+  int depth;         // current depth of the search stack of the calling thread
+};
+
+// searchHook, if set, is called every SEARCH_HOOK_INTERVAL expansions of runGame, or of all threads of runGameParallel, where one thread at a time calls it. returning false cancels the search.
+const uint64_t SEARCH_HOOK_INTERVAL = 1 << 16;
+bool (*searchHook)(const SearchProgress &progress) = nullptr;
+
+// SearchStats counts the work of one thread of runGame or runGameParallel while collectStats is set.
+// every thread only writes its own SearchStats, and each one takes whole cache lines, so counting needs no atomics and threads do not share lines.
+struct alignas(64) SearchStats
+{
+  uint64_t expanded = 0; // positions searched, i.e. pushed on the search stack
+  uint64_t lookups = 0;  // children and regions looked up in the nimber table
+  uint64_t hits = 0;     // lookups that found a nimber
+  uint64_t moves = 0;    // distinct moves of the expanded positions, for the average branching factor
+  int maxDepth = 0;      // deepest search stack
+  uint64_t layerExpanded[MAX_VERTICES + 1] = {};
+  uint64_t layerLookups[MAX_VERTICES + 1] = {};
+  uint64_t layerHits[MAX_VERTICES + 1] = {};
+};
+
+// collectStats turns on counting into searchStats, which has one SearchStats per thread of the last search. it is off by default, and when off the searches only pay for testing it.
+bool collectStats = false;
+vector<SearchStats> searchStats(1);
+
+// countExpansion(stats, state, moves, depth) counts a position with moves distinct moves pushed at depth of the search stack
+inline void countExpansion(SearchStats &stats, const State &state, int moves, int depth)
+{
+  stats.expanded++;
+  stats.layerExpanded[popcount(state)]++;
+  stats.moves += moves;
+  stats.maxDepth = max(stats.maxDepth, depth);
+}
+
+inline void countExpansion(SearchStats &stats, const SearchFrame &frame, int depth)
+{
+  countExpansion(stats, frame.state, popcount(frame.movesLeft), depth);
+}
+
+// countLookup(stats, state, hit) counts a lookup of state in the nimber table
+inline void countLookup(SearchStats &stats, const State &state, bool hit)
+{
+  int ones = popcount(state);
+  stats.lookups++;
+  stats.layerLookups[ones]++;
+  if (hit)
+  {
+    stats.hits++;
+    stats.layerHits[ones]++;
+  }
+}
+
+// mergedStats() adds up the SearchStats of every thread of the last search
+SearchStats mergedStats()
+{
+  SearchStats total;
+  for (int t = 0; t < (int)searchStats.size(); t++)
+  {
+    const SearchStats &stats = searchStats[t];
+    total.expanded += stats.expanded;
+    total.lookups += stats.lookups;
+    total.hits += stats.hits;
+    total.moves += stats.moves;
+    total.maxDepth = max(total.maxDepth, stats.maxDepth);
+    for (int p = 0; p <= MAX_VERTICES; p++)
+    {
+      total.layerExpanded[p] += stats.layerExpanded[p];
+      total.layerLookups[p] += stats.layerLookups[p];
+      total.layerHits[p] += stats.layerHits[p];
+    }
+  }
+  return total;
+}
+
+// printSearchStats(out, table) prints the merged counters of the last search, the state of its table, and the counters of every layer (number of 1's) that was reached.
+// a low hit rate with a full table points at memory, a high branching factor at the game itself, and many evictions or lookups per expansion at the table.
+void printSearchStats(ostream &out, const NimTable &table)
+{
+  SearchStats total = mergedStats();
+  auto percent = [](uint64_t part, uint64_t whole)
+  { return whole == 0 ? 0.0 : 100.0 * part / whole; };
+  out << "expanded " << total.expanded << " positions on " << searchStats.size() << " thread(s), maximum depth " << total.maxDepth
+      << ", average branching factor " << (total.expanded == 0 ? 0.0 : (double)total.moves / total.expanded) << "\n";
+  out << "table lookups " << total.lookups << ", hit rate " << percent(total.hits, total.lookups) << "%\n";
+  out << "table holds " << table.used << " entries in " << table.bucketCount << " buckets (" << tableBytes(table) / (1 << 20) << " MB), "
+      << table.evictions << " evictions\n";
+  for (int p = MAX_VERTICES; p >= 0; p--)
+  {
+    if (total.layerExpanded[p] == 0 && total.layerLookups[p] == 0)
+      continue;
+    out << "layer " << p << ": expanded " << total.layerExpanded[p] << ", lookups " << total.layerLookups[p] << ", hit rate "
+        << percent(total.layerHits[p], total.layerLookups[p]) << "%\n";
+  }
+}
+
+// pushFrame(frame, state, key, memo) makes frame the start of the search of state
+inline void pushFrame(SearchFrame &frame, const State &state, uint64_t key, uint64_t memo)
+{
+  frame.state = state;
+  frame.movesLeft = distinctMoves(state);
+  frame.seen = emptyState();
+  frame.deferred = emptyState();
+  frame.crowded = emptyState();
+  frame.key = key;
+  frame.memo = memo;
+  frame.split = false;
+}
+
+// Region is a group of 1's of a position together with the vertices they can ever light up and play, see closeRegion
+struct Region
+{
+  State ones;     // the 1's of the position in the region
+  State reach;    // vertices that can be 1 in some game from ones
+  State playable; // vertices that can be played in some game from ones
+  State halo;     // reach and its neighbors
+};
+
+// splitRegions turns on splitFrame. the check costs about as much as expanding the position again, which only pays off when positions do fall apart, like sparse 1's spread over long ladders and grids, so it is off by default.
+bool splitRegions = false;
+
+// regions is the scratch list of splitFrame, and regionParts holds the 1's of the regions that split frames still have to solve, the last region of the deepest frame on top
+vector<Region> regions;
+vector<State> regionParts;
+
+// neighborhoodUnion(s) returns the union of the closed neighborhoods of the vertices in s
+inline State neighborhoodUnion(const State &s)
+{
+  State result = emptyState();
+  for (int j = 0; j < STATE_WORDS; j++)
+  {
+    for (uint64_t word = s.w[j]; word != 0; word &= word - 1)
+      result = result | nbhdMasks[64 * j + __builtin_ctzll(word)];
+  }
+  return result;
+}
+
+// closeRegion(region) fills in reach, playable and halo of a region from its ones, as if the rest of the position were 0.
+// a vertex can only be played while it is 1 and the majority of its neighborhood is 1, so each round the vertices that can be 1 grow by the neighborhood of every vertex that could pass that test within them.
+// every move turns off at least one 1, so a game from ones lasts at most popcount(ones) moves, and that many rounds are enough.
+// a test only changes when the neighborhood of the vertex grew, so each round only retests the neighbors of the vertices added in the last one.
+void closeRegion(Region &region)
+{
+  region.reach = region.ones;
+  region.playable = emptyState();
+  State candidates = region.ones;
+  for (int round = popcount(region.ones); round > 0; round--)
+  {
+    State grown = emptyState();
+    for (int j = 0; j < STATE_WORDS; j++)
+    {
+      for (uint64_t word = candidates.w[j]; word != 0; word &= word - 1)
+      {
+        int v = 64 * j + __builtin_ctzll(word);
+        if (2 * popcount(nbhdMasks[v] & region.reach) > nbhdSize[v])
+        {
+          grown = grown | nbhdMasks[v];
+          setBit(region.playable, v);
+        }
+      }
+    }
+    grown = grown & ~region.reach;
+    if (grown == emptyState())
+      break;
+    region.reach = region.reach | grown;
+    candidates = neighborhoodUnion(grown) & region.reach & ~region.playable;
+  }
+  region.halo = neighborhoodUnion(region.reach);
+}
+
+// splitFrame(frame) turns frame into a sum of regions when the 1's of its state fall into groups that can never interact, pushing the 1's of each group onto regionParts.
+// groups start as the pieces of the 1's that are connected through paths of length at most 2, which is coarse but cheap since it makes most dense positions a single group at once, and are merged while the vertices one group can light up touch those of another. once no two groups touch, every move of a game stays inside one group and only sees 1's of that group, so the position is a disjunctive sum and its nimber is the XOR of the nimbers of the groups, which are searched and memoized as positions of their own.
+// 1's that are no neighbor of any playable vertex can never change or affect a move, so they are dropped, and positions that only differ there share their memo entries.
+void splitFrame(SearchFrame &frame)
+{
+  if (!splitRegions)
+    return;
+  regions.clear();
+  for (State left = frame.state; left != emptyState();)
+  {
+    Region region;
+    State frontier = emptyState();
+    setBit(frontier, firstUnset(~left));
+    region.ones = emptyState();
+    while (frontier != emptyState())
+    {
+      region.ones = region.ones | frontier;
+      frontier = neighborhoodUnion(neighborhoodUnion(frontier)) & left & ~region.ones;
+    }
+    left = left & ~region.ones;
+    if (region.ones == frame.state)
+      return; // the 1's form a single group
+    closeRegion(region);
+    regions.push_back(region);
+  }
+
+  // merge every region into the first region it touches, then recompute the merged regions, until no two regions touch
+  bool merged = true;
+  while (merged)
+  {
+    merged = false;
+    for (int i = 0; i < (int)regions.size(); i++)
+    {
+      bool grew = false;
+      for (int j = (int)regions.size() - 1; j > i; j--)
+      {
+        if ((regions[i].halo & regions[j].reach) != emptyState())
+        {
+          regions[i].ones = regions[i].ones | regions[j].ones;
+          regions[i].reach = regions[i].reach | regions[j].reach;
+          regions[i].halo = regions[i].halo | regions[j].halo;
+          regions[j] = regions.back();
+          regions.pop_back();
+          grew = true;
+        }
+      }
+      if (grew)
+      {
+        closeRegion(regions[i]);
+        merged = true;
+      }
+    }
+  }
+
+  int parts = 0;
+  for (int i = 0; i < (int)regions.size(); i++)
+  {
+    if (regions[i].playable != emptyState())
+    {
+      regionParts.push_back(regions[i].ones & neighborhoodUnion(regions[i].playable));
+      parts++;
+    }
+  }
+  if (parts == 0 || (parts == 1 && regionParts.back() == frame.state))
+  {
+    regionParts.resize(regionParts.size() - parts);
+    return;
+  }
+  frame.split = true;
+  frame.parts = parts;
+  frame.movesLeft = emptyState();
+  frame.sum = 0;
+}
+
+// reportNimber(frame, nimber) passes the nimber of a child position, or of a region, to the frame that searched it
+inline void reportNimber(SearchFrame &frame, int nimber)
+{
+  if (frame.split)
+    frame.sum ^= nimber;
+  else
+    setBit(frame.seen, nimber);
+}
+
+// runGame(startState, key) computes the nimber of startState, whose Zobrist key is key, by traversing through the whole subtree from that point, memoizing game states it has already seen.
+// the traversal is depth first but uses searchStack instead of recursion, so deep games do not need a large call stack.
+// children are reached by toggling a vertex, so their keys are updated incrementally from key, and looked up under memoKey.
+// with splitRegions on, a position that splits into independent regions is solved region by region, see splitFrame. every region has fewer 1's than its position, so the stack still stays within numVertices + 1 frames.
+// returns -1 if searchHook cancels the search.
+int runGame(const State &startState, uint64_t key)
+{
+  int stateNimber;
+  uint64_t memo = memoKey(startState, key);
+  bool hit = lookupNimber(nimberComps, memo, stateNimber);
+  if (collectStats)
+    countLookup(searchStats[0], startState, hit);
+  if (hit)
+    return stateNimber;
+
+  if ((int)searchStack.size() < numVertices + 1)
+    searchStack.resize(numVertices + 1);
+  uint64_t expanded = 1;
+  int depth = 0;
+  regionParts.clear();
+  pushFrame(searchStack[0], startState, key, memo);
+  splitFrame(searchStack[0]);
+  if (collectStats)
+    countExpansion(searchStats[0], searchStack[0], 0);
+
+  while (true)
+  {
+    SearchFrame &frame = searchStack[depth];
+    if (frame.split && frame.parts > 0)
+    {
+      // solve the next region of a sum
+      State part = regionParts.back();
+      regionParts.pop_back();
+      frame.parts--;
+      uint64_t partKey = hashState(part);
+      uint64_t partMemo = memoKey(part, partKey);
+      int partNimber;
+      hit = lookupNimber(nimberComps, partMemo, partNimber);
+      if (collectStats)
+        countLookup(searchStats[0], part, hit);
+      if (hit)
+      {
+        frame.sum ^= partNimber;
+        continue;
+      }
+      pushFrame(searchStack[++depth], part, partKey, partMemo);
+      splitFrame(searchStack[depth]);
+      if (collectStats)
+        countExpansion(searchStats[0], searchStack[depth], depth);
+      continue;
+    }
+
+    int place = firstUnset(~frame.movesLeft);
+    if (place == MAX_VERTICES)
+    {
+      // every child has been visited, so the nimber of this position is known
+      stateNimber = frame.split ? frame.sum : mex(frame.seen);
+      storeNimber(nimberComps, frame.memo, stateNimber, popcount(frame.state));
+
+      // debug
+      // cout << stateToString(frame.state, numVertices) << ": " << stateNimber << "\n";
+
+      if (depth == 0)
+        return stateNimber;
+      depth--;
+      reportNimber(searchStack[depth], stateNimber);
+      continue;
+    }
+
+    clearBit(frame.movesLeft, place);
+    State child = toggle(frame.state, place);
+    uint64_t childKey = frame.key ^ nbhdZobrist[place];
+    uint64_t childMemo = memoKey(child, childKey);
+    int childNimber;
+    hit = lookupNimber(nimberComps, childMemo, childNimber);
+    if (collectStats)
+      countLookup(searchStats[0], child, hit);
+    if (hit)
+    {
+      setBit(frame.seen, childNimber);
+      continue;
+    }
+
+    pushFrame(searchStack[++depth], child, childKey, childMemo);
+    splitFrame(searchStack[depth]);
+    if (collectStats)
+      countExpansion(searchStats[0], searchStack[depth], depth);
+    if (searchHook != nullptr && ++expanded % SEARCH_HOOK_INTERVAL == 0 && !searchHook({expanded, depth}))
+      return -1;
+  }
+}
+
+// runGame(startState) computes the nimber of startState, hashing it from scratch
+int runGame(const State &startState)
+{
+  return runGame(startState, hashState(startState));
+}
+
+// the functions below only decide the outcome of a position: whether it is a P-position (nimber 0, a win for the second player) or an N-position.
+// a position is an N-position as soon as one child is a P-position, so the search stops at the first P-child it finds, where runGame has to solve every child.
+// outcomes are kept in outcomeComps and not in nimberComps, since an N-position's entry there only says that its nimber is not 0.
+// an outcome takes a whole 8-byte entry like a nimber, since 1-bit entries would have to drop most of their fingerprint and with it the check that tells states apart.
+NimTable outcomeComps;
+const int P_POSITION = 0, N_POSITION = 1;
+
+// OutcomeFrame is one position on the explicit stack of runOutcome, with the children that are still to be tried in the order they will be tried
+struct OutcomeFrame
+{
+  State state;
+  uint64_t key;
+  uint64_t memo;
+  bool won;                        // a child is a P-position, so state is an N-position
+  int next, count;                 // moves[next] through moves[count - 1] are still to be tried
+  int moves[MAX_VERTICES];
+};
+
+vector<OutcomeFrame> outcomeStack;
+
+// lookupOutcome(memo, outcome) sets outcome to the known outcome of the state with memo key memo, from outcomeComps or from its nimber in nimberComps, and returns whether it is known
+inline bool lookupOutcome(uint64_t memo, int &outcome)
+{
+  int nimber;
+  if (lookupNimber(outcomeComps, memo, outcome))
+    return true;
+  if (nimberComps.buckets != nullptr && nimberComps.used > 0 && lookupNimber(nimberComps, memo, nimber))
+  {
+    outcome = nimber == 0 ? P_POSITION : N_POSITION;
+    return true;
+  }
+  return false;
+}
+
+// expandOutcome(frame, state, key, memo) makes frame the start of the search of state.
+// every child is looked up first, so a known P-child ends the frame at once and known N-children are never tried.
+// the unknown children are tried in order of how many moves they have, fewest first: a position with few moves is more likely to be a P-position, and cheaper to search if it is not.
+void expandOutcome(OutcomeFrame &frame, const State &state, uint64_t key, uint64_t memo)
+{
+  frame.state = state;
+  frame.key = key;
+  frame.memo = memo;
+  frame.won = false;
+  frame.next = 0;
+  frame.count = 0;
+  int score[MAX_VERTICES];
+  State moves = distinctMoves(state);
+  for (int j = 0; j < STATE_WORDS && !frame.won; j++)
+  {
+    for (uint64_t word = moves.w[j]; word != 0; word &= word - 1)
+    {
+      int place = 64 * j + __builtin_ctzll(word);
+      State child = toggle(state, place);
+      int outcome;
+      bool hit = lookupOutcome(memoKey(child, key ^ nbhdZobrist[place]), outcome);
+      if (collectStats)
+        countLookup(searchStats[0], child, hit);
+      if (hit && outcome == P_POSITION)
+      {
+        frame.won = true;
+        break;
+      }
+      if (!hit)
+      {
+        score[place] = popcount(legalMoves(child));
+        frame.moves[frame.count++] = place;
+      }
+    }
+  }
+  sort(frame.moves, frame.moves + frame.count, [&](int x, int y)
+       { return score[x] < score[y]; });
+}
+
+// runOutcome(startState) decides whether startState is a P-position or an N-position, returning P_POSITION or N_POSITION, or -1 if searchHook cancels the search.
+// outcomeComps is set up without a memory cap if it has not been initialized.
+// like runGame it searches depth first on an explicit stack, but a position is done as soon as one of its children is a P-position.
+// region splitting does not apply, since the outcome of a sum depends on the nimbers of its regions and not just their outcomes.
+int runOutcome(const State &startState)
+{
+  uint64_t key = hashState(startState);
+  uint64_t memo = memoKey(startState, key);
+  int outcome;
+  if (outcomeComps.buckets == nullptr)
+    initTable(outcomeComps, 0);
+  if (lookupOutcome(memo, outcome))
+    return outcome;
+
+  if ((int)outcomeStack.size() < numVertices + 1)
+    outcomeStack.resize(numVertices + 1);
+  uint64_t expanded = 1;
+  int depth = 0;
+  expandOutcome(outcomeStack[0], startState, key, memo);
+  if (collectStats)
+    countExpansion(searchStats[0], startState, outcomeStack[0].count, 0);
+
+  while (true)
+  {
+    OutcomeFrame &frame = outcomeStack[depth];
+    if (frame.won || frame.next == frame.count)
+    {
+      // either a child is a P-position, or every child is an N-position
+      outcome = frame.won ? N_POSITION : P_POSITION;
+      storeNimber(outcomeComps, frame.memo, outcome, popcount(frame.state));
+      if (depth == 0)
+        return outcome;
+      depth--;
+      if (outcome == P_POSITION)
+        outcomeStack[depth].won = true;
+      continue;
+    }
+
+    // a child may have been solved below an earlier sibling since the frame was expanded
+    int place = frame.moves[frame.next++];
+    State child = toggle(frame.state, place);
+    uint64_t childKey = frame.key ^ nbhdZobrist[place];
+    uint64_t childMemo = memoKey(child, childKey);
+    if (lookupOutcome(childMemo, outcome))
+    {
+      frame.won = outcome == P_POSITION;
+      continue;
+    }
+
+    expandOutcome(outcomeStack[++depth], child, childKey, childMemo);
+    if (collectStats)
+      countExpansion(searchStats[0], child, outcomeStack[depth].count, depth);
+    if (searchHook != nullptr && ++expanded % SEARCH_HOOK_INTERVAL == 0 && !searchHook({expanded, depth}))
+      return -1;
+  }
+}
+
+// runGameLayered(startState, threads) computes the nimber of startState with a retrograde analysis instead of a depth first search.
+// every move lowers the number of 1's, so the positions reachable from startState fall into layers by their number of 1's, and each layer only depends on lower layers.
+// the reachable positions are first enumerated from the top layer down, then the layers are solved from the bottom up, with every layer split across threads threads.
+// a move turns off at most max(nbhdSize) 1's, so a layer is freed as soon as every layer that could still reach it is solved.
+// layers only hold canonicalState of each position, so symmetric positions are enumerated and solved once.
+int runGameLayered(const State &startState, int threads)
+{
+  int top = popcount(startState);
+  int maxDrop = *max_element(nbhdSize.begin(), nbhdSize.end());
+  // layers[p] holds the reachable positions with p 1's, sorted
+  vector<vector<State>> layers(top + 1);
+  layers[top].push_back(canonicalState(startState));
+
+  for (int p = top; p >= 0; p--)
+  {
+    vector<State> &layer = layers[p];
+    sort(layer.begin(), layer.end());
+    layer.erase(unique(layer.begin(), layer.end()), layer.end());
+    layer.shrink_to_fit();
+    if (p == 0)
+      break;
+
+    // found[t][q] collects the children with q 1's found by thread t
+    vector<vector<vector<State>>> found(threads, vector<vector<State>>(p));
+    parallelFor(layer.size(), threads, [&](size_t begin, size_t end, int t)
+                {
+      for (size_t i = begin; i < end; i++)
+      {
+        State legal = distinctMoves(layer[i]);
+        for (int j = 0; j < STATE_WORDS; j++)
+        {
+          for (uint64_t word = legal.w[j]; word != 0; word &= word - 1)
+          {
+            State child = canonicalState(toggle(layer[i], 64 * j + __builtin_ctzll(word)));
+            found[t][popcount(child)].push_back(child);
+          }
+        }
+      } });
+    for (int t = 0; t < threads; t++)
+    {
+      for (int q = 0; q < p; q++)
+        layers[q].insert(layers[q].end(), found[t][q].begin(), found[t][q].end());
+    }
+  }
+
+  // nimbers[p][i] is the nimber of layers[p][i]
+  vector<vector<uint8_t>> nimbers(top + 1);
+  for (int p = 0; p <= top; p++)
+  {
+    vector<State> &layer = layers[p];
+    nimbers[p].resize(layer.size());
+    parallelFor(layer.size(), threads, [&](size_t begin, size_t end, int)
+                {
+      for (size_t i = begin; i < end; i++)
+      {
+        State legal = distinctMoves(layer[i]);
+        State seen = emptyState();
+        for (int j = 0; j < STATE_WORDS; j++)
+        {
+          for (uint64_t word = legal.w[j]; word != 0; word &= word - 1)
+          {
+            State child = canonicalState(toggle(layer[i], 64 * j + __builtin_ctzll(word)));
+            int q = popcount(child);
+            size_t index = lower_bound(layers[q].begin(), layers[q].end(), child) - layers[q].begin();
+            setBit(seen, nimbers[q][index]);
+          }
+        }
+        nimbers[p][i] = mex(seen);
+      } });
+    if (p - maxDrop >= 0)
+    {
+      vector<State>().swap(layers[p - maxDrop]);
+      vector<uint8_t>().swap(nimbers[p - maxDrop]);
+    }
+  }
+  return nimbers[top][0];
+}
+
+// DenseTable holds the nimber of every one of the 2^n positions of a graph with at most DENSE_MAX_VERTICES vertices, indexed by the bits of the position, see solveDense.
+// nimbers are packed 4 bits per position, two positions to a byte. nimbers of DENSE_OVERFLOW or more are marked DENSE_OVERFLOW and kept in overflow.
+const int DENSE_MAX_VERTICES = 32;
+const int DENSE_OVERFLOW = 15;
+
+struct DenseTable
+{
+  int vertices = 0;
+  vector<uint8_t> nibbles;
+  unordered_map<uint64_t, int> overflow;
+  vector<vector<uint64_t>> layerCounts; // layerCounts[p][g] is the number of positions with p 1's and nimber g
+};
+
+// denseIndex(s) returns the index of a position of a small graph in a DenseTable
+inline uint64_t denseIndex(const State &s)
+{
+  return s.w[0];
+}
+
+// denseNimber(table, index) returns the nimber of the position with the given index.
+// the byte is read atomically, since while solveDense runs another thread may be filling in the other position of the byte
+inline int denseNimber(const DenseTable &table, uint64_t index)
+{
+  int nimber = (__atomic_load_n(&table.nibbles[index >> 1], __ATOMIC_RELAXED) >> (4 * (index & 1))) & 15;
+  return nimber == DENSE_OVERFLOW ? table.overflow.at(index) : nimber;
+}
+
+// solveDense(table, threads) fills table with the nimbers of every position of the current graph, layer by layer from the fewest 1's up, splitting every layer across threads threads.
+// the positions of a layer are walked in increasing order, each thread unranking the first combination of its chunk and stepping to the next one with Gosper's hack.
+// the two positions sharing a byte only differ in vertex 0, so they are never in the same layer, but one may be a child being read while the other is written.
+// so the bytes are read and written with relaxed atomic loads and stores. no two threads write one byte in the same layer, so a load and a store keep both halves intact without a locked OR.
+void solveDense(DenseTable &table, int threads)
+{
+  int n = numVertices;
+  if (n > DENSE_MAX_VERTICES)
+  {
+    cout << "the dense table holds graphs of at most " << DENSE_MAX_VERTICES << " vertices, this one has " << n << "\n";
+    exit(1);
+  }
+  vector<uint64_t> masks(n);
+  for (int i = 0; i < n; i++)
+    masks[i] = nbhdMasks[i].w[0];
+  vector<vector<uint64_t>> choose(n + 1, vector<uint64_t>(n + 1, 0));
+  for (int a = 0; a <= n; a++)
+  {
+    choose[a][0] = 1;
+    for (int b = 1; b <= a; b++)
+      choose[a][b] = choose[a - 1][b - 1] + choose[a - 1][b];
+  }
+
+  table.vertices = n;
+  table.nibbles = vector<uint8_t>(((uint64_t(1) << n) + 1) / 2, 0);
+  table.overflow = unordered_map<uint64_t, int>();
+  table.layerCounts = vector<vector<uint64_t>>(n + 1, vector<uint64_t>(n + 2, 0));
+  for (int p = 0; p <= n; p++)
+  {
+    // counts[t][g] and overflow[t] collect what thread t found, merged once the layer is done
+    vector<vector<uint64_t>> counts(threads, vector<uint64_t>(n + 2, 0));
+    vector<vector<pair<uint64_t, int>>> overflow(threads);
+    parallelFor(choose[n][p], threads, [&](size_t begin, size_t end, int t)
+                {
+      // unrank combination number begin, in increasing order of the positions
+      uint64_t s = 0;
+      uint64_t rank = begin;
+      for (int i = p, c = n - 1; i > 0; i--)
+      {
+        while (choose[c][i] > rank)
+          c--;
+        s |= uint64_t(1) << c;
+        rank -= choose[c][i];
+        c--;
+      }
+      for (size_t r = begin; r < end; r++)
+      {
+        uint64_t seen = 0;
+        for (uint64_t moves = s; moves != 0; moves &= moves - 1)
+        {
+          int v = __builtin_ctzll(moves);
+          if (2 * __builtin_popcountll(s & masks[v]) > nbhdSize[v])
+            seen |= uint64_t(1) << denseNimber(table, s ^ masks[v]);
+        }
+        int nimber = __builtin_ctzll(~seen);
+        counts[t][nimber]++;
+        if (nimber >= DENSE_OVERFLOW)
+        {
+          overflow[t].push_back({s, nimber});
+          nimber = DENSE_OVERFLOW;
+        }
+        uint8_t &byte = table.nibbles[s >> 1];
+        __atomic_store_n(&byte, uint8_t(__atomic_load_n(&byte, __ATOMIC_RELAXED) | nimber << (4 * (s & 1))), __ATOMIC_RELAXED);
+        if (p > 0 && r + 1 < end)
+        {
+          uint64_t low = s | (s - 1);
+          s = (low + 1) | (((~low & (low + 1)) - 1) >> (__builtin_ctzll(s) + 1));
+        }
+      } });
+    for (int t = 0; t < threads; t++)
+    {
+      for (int g = 0; g <= n + 1; g++)
+        table.layerCounts[p][g] += counts[t][g];
+      for (int i = 0; i < (int)overflow[t].size(); i++)
+        table.overflow[overflow[t][i].first] = overflow[t][i].second;
+    }
+  }
+}
+
+// printDenseLayers(table) prints, for every number of 1's, how many positions there are, how many are P-positions (nimber 0) and how many have each nimber
+void printDenseLayers(const DenseTable &table)
+{
+  for (int p = 0; p <= table.vertices; p++)
+  {
+    const vector<uint64_t> &counts = table.layerCounts[p];
+    uint64_t total = 0;
+    for (int g = 0; g < (int)counts.size(); g++)
+      total += counts[g];
+    cout << "layer " << p << ": " << total << " positions, " << counts[0] << " P-positions, nimbers";
+    for (int g = 0; g < (int)counts.size(); g++)
+    {
+      if (counts[g] > 0)
+        cout << " " << g << ":" << counts[g];
+    }
+    cout << "\n";
+  }
+}
+
+// SearchTask is a position queued for runGameParallel, with its Zobrist key and the key it has in the nimber table
+struct SearchTask
+{
+  State state;
+  uint64_t key;
+  uint64_t memo;
+};
+
+// TaskQueue is the work queue of one runGameParallel thread. the owner takes its newest task and other threads steal the oldest one, which is the biggest subtree.
+// the tasks still queued are tasks[head] through tasks.back(). the vector is reset once it runs empty, so it keeps its capacity and queueing stops allocating once the search is warm.
+struct TaskQueue
+{
+  mutex lock;
+  vector<SearchTask> tasks;
+  size_t head = 0;
+};
+
+// frames this shallow in a task queue their children so that idle threads can steal them
+const int PARALLEL_SPAWN_DEPTH = 3;
+
+// ParallelSearch is the state of a runGameParallel search that its threads share besides nimberComps and the task queues
+struct ParallelSearch
+{
+  atomic<bool> done{false};     // the root is solved or searchHook cancelled the search
+  atomic<uint64_t> expanded{0}; // expansions of all threads, added in batches of PARALLEL_COUNT_BATCH
+  atomic<uint64_t> nextHook{SEARCH_HOOK_INTERVAL}; // value of expanded at which searchHook is called next
+  mutex hookLock;                                  // held by the thread calling searchHook
+};
+
+// PARALLEL_COUNT_BATCH is how many expansions a thread counts on its own before adding them to ParallelSearch::expanded
+const uint64_t PARALLEL_COUNT_BATCH = 1 << 12;
+
+// pollSearchHook(search, total, depth, waiting) calls searchHook for a thread of search at depth once total, the expansions so far, reaches nextHook, or if waiting is set at once,
+// so that a thread waiting for another one still stops the search and writes checkpoints. a thread that finds another one calling searchHook goes on without it.
+// returns false, setting done, if searchHook cancels the search.
+bool pollSearchHook(ParallelSearch &search, uint64_t total, int depth, bool waiting)
+{
+  if (searchHook == nullptr || (!waiting && total < search.nextHook))
+    return true;
+  unique_lock<mutex> guard(search.hookLock, try_to_lock);
+  if (!guard.owns_lock() || (!waiting && total < search.nextHook))
+    return true;
+  search.nextHook = total + SEARCH_HOOK_INTERVAL;
+  if (searchHook({total, depth}))
+    return true;
+  search.done = true;
+  return false;
+}
+
+// takeTask(queues, me, task) pops the newest task of thread me, or steals the oldest task of another thread. returns false if every queue is empty.
+bool takeTask(vector<TaskQueue> &queues, int me, SearchTask &task)
+{
+  for (int i = 0; i < (int)queues.size(); i++)
+  {
+    TaskQueue &queue = queues[(me + i) % queues.size()];
+    lock_guard<mutex> guard(queue.lock);
+    if (queue.head < queue.tasks.size())
+    {
+      if (i == 0)
+      {
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+      }
+      else
+      {
+        task = queue.tasks[queue.head++];
+      }
+      if (queue.head == queue.tasks.size())
+      {
+        queue.tasks.clear();
+        queue.head = 0;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+// abandonTask(stack, depth) releases the claims on the positions of stack[0] through stack[depth] once the search is done, so the table holds no claims that nobody will publish. returns -1.
+int abandonTask(const vector<SearchFrame> &stack, int depth)
+{
+  for (int d = 0; d <= depth; d++)
+    if (stack[d].claimed)
+      releaseClaim(nimberComps, stack[d].memo);
+  return -1;
+}
+
+// solveTask(task, stack, queue, search, me, expanded) solves task for thread me the way runGame does, on stack, publishing every nimber to nimberComps.
+// a child that another thread has claimed is put off until the other children are done, and only then waited for.
+// waiting cannot deadlock: a thread only waits for states with fewer 1's than every state it has claimed.
+// a child whose bucket is full of claims is put off the same way, and solved without a claim if its bucket is still full when it comes up again,
+// since the claims filling it may be held by this thread's own frames. a task in such a bucket is solved without a claim at once.
+// expanded counts the expansions of thread me, which are added to search every PARALLEL_COUNT_BATCH. thread me polls searchHook then, and every PARALLEL_COUNT_BATCH rounds of waiting for another thread.
+// returns the nimber of the task, or -1 if it was already claimed or the search is done.
+int solveTask(const SearchTask &task, vector<SearchFrame> &stack, TaskQueue &queue, ParallelSearch &search, int me, uint64_t &expanded)
+{
+  ClaimResult claim = claimState(nimberComps, task.memo, popcount(task.state));
+  if (claim == CLAIM_HELD)
+    return -1;
+  int depth = 0;
+  pushFrame(stack[0], task.state, task.key, task.memo);
+  stack[0].claimed = claim == CLAIM_TAKEN;
+  if (collectStats)
+    countExpansion(searchStats[me], stack[0], 0);
+  bool spawn = true;
+  uint64_t waits = 0; // rounds spent waiting for children claimed by other threads
+
+  while (true)
+  {
+    SearchFrame &frame = stack[depth];
+    if (spawn && depth < PARALLEL_SPAWN_DEPTH)
+    {
+      // queue the children of a shallow frame for idle threads
+      lock_guard<mutex> guard(queue.lock);
+      for (int j = 0; j < STATE_WORDS; j++)
+      {
+        for (uint64_t word = frame.movesLeft.w[j]; word != 0; word &= word - 1)
+        {
+          int place = 64 * j + __builtin_ctzll(word);
+          State child = toggle(frame.state, place);
+          uint64_t childKey = frame.key ^ nbhdZobrist[place];
+          queue.tasks.push_back({child, childKey, memoKey(child, childKey)});
+        }
+      }
+    }
+    spawn = false;
+
+    int place = firstUnset(~frame.movesLeft);
+    if (place == MAX_VERTICES && popcount(frame.deferred) > 0)
+    {
+      // only children claimed by other threads are left: take the solved ones, solve the abandoned ones, wait for the rest
+      bool waiting = true;
+      for (int j = 0; j < STATE_WORDS; j++)
+      {
+        for (uint64_t word = frame.deferred.w[j]; word != 0; word &= word - 1)
+        {
+          int move = 64 * j + __builtin_ctzll(word);
+          State child = toggle(frame.state, move);
+          int childNimber = probeNimber(nimberComps, memoKey(child, frame.key ^ nbhdZobrist[move]));
+          if (childNimber == CLAIMED_NIMBER)
+            continue;
+          clearBit(frame.deferred, move);
+          if (childNimber >= 0)
+            setBit(frame.seen, childNimber);
+          else
+            setBit(frame.movesLeft, move);
+          waiting = false;
+        }
+      }
+      if (waiting && (search.done || (++waits % PARALLEL_COUNT_BATCH == 0 && !pollSearchHook(search, search.expanded, depth, true))))
+        return abandonTask(stack, depth);
+      if (waiting)
+        this_thread::yield();
+      continue;
+    }
+    if (place == MAX_VERTICES)
+    {
+      int stateNimber = mex(frame.seen);
+      publishNimber(nimberComps, frame.memo, stateNimber, popcount(frame.state));
+      if (depth == 0)
+        return stateNimber;
+      depth--;
+      setBit(stack[depth].seen, stateNimber);
+      continue;
+    }
+
+    clearBit(frame.movesLeft, place);
+    State child = toggle(frame.state, place);
+    uint64_t childKey = frame.key ^ nbhdZobrist[place];
+    uint64_t childMemo = memoKey(child, childKey);
+    int childNimber = probeNimber(nimberComps, childMemo);
+    if (collectStats)
+      countLookup(searchStats[me], child, childNimber >= 0 && childNimber != CLAIMED_NIMBER);
+    if (childNimber >= 0 && childNimber != CLAIMED_NIMBER)
+    {
+      setBit(frame.seen, childNimber);
+      continue;
+    }
+    ClaimResult claim = childNimber < 0 ? claimState(nimberComps, childMemo, popcount(child)) : CLAIM_HELD;
+    if (claim == CLAIM_HELD || (claim == CLAIM_BUSY && !testBit(frame.crowded, place)))
+    {
+      if (claim == CLAIM_BUSY)
+        setBit(frame.crowded, place);
+      setBit(frame.deferred, place);
+      continue;
+    }
+    pushFrame(stack[++depth], child, childKey, childMemo);
+    stack[depth].claimed = claim == CLAIM_TAKEN;
+    spawn = true;
+    if (collectStats)
+      countExpansion(searchStats[me], stack[depth], depth);
+    if (++expanded % PARALLEL_COUNT_BATCH == 0)
+    {
+      uint64_t total = search.expanded.fetch_add(PARALLEL_COUNT_BATCH) + PARALLEL_COUNT_BATCH;
+      if (search.done || !pollSearchHook(search, total, depth, false))
+        return abandonTask(stack, depth);
+    }
+  }
+}
+
+// runGameParallel(startState, threads) computes the nimber of startState with threads threads searching depth first at once.
+// each thread has its own search stack and task queue, and threads that run out of work steal queued subtrees from the others.
+// all threads share nimberComps, which has to be at its full size (see presizeTable) before the search starts.
+// returns -1 if searchHook cancels the search.
+int runGameParallel(const State &startState, int threads)
+{
+  uint64_t rootKey = hashState(startState);
+  uint64_t rootMemo = memoKey(startState, rootKey);
+  int rootNimber = probeNimber(nimberComps, rootMemo);
+  if (collectStats)
+  {
+    if ((int)searchStats.size() < threads)
+      searchStats.resize(threads);
+    countLookup(searchStats[0], startState, rootNimber >= 0 && rootNimber != CLAIMED_NIMBER);
+  }
+  if (rootNimber >= 0 && rootNimber != CLAIMED_NIMBER)
+    return rootNimber;
+
+  vector<TaskQueue> queues(threads);
+  queues[0].tasks.push_back({startState, rootKey, rootMemo});
+  ParallelSearch search;
+  atomic<int> result(-1);
+  auto worker = [&](int me)
+  {
+    vector<SearchFrame> stack(numVertices + 1);
+    SearchTask task;
+    uint64_t expanded = 0;
+    while (!search.done)
+    {
+      if (!takeTask(queues, me, task))
+      {
+        this_thread::yield();
+        continue;
+      }
+      int nimber = solveTask(task, stack, queues[me], search, me, expanded);
+      if (task.memo == rootMemo && nimber >= 0)
+      {
+        result = nimber;
+        search.done = true;
+      }
+      // every child queued while solving the task is solved by now
+      lock_guard<mutex> guard(queues[me].lock);
+      queues[me].tasks.clear();
+      queues[me].head = 0;
+    }
+  };
+  vector<thread> pool;
+  for (int t = 1; t < threads; t++)
+    pool.emplace_back(worker, t);
+  worker(0);
+  for (int t = 0; t < (int)pool.size(); t++)
+    pool[t].join();
+  return result;
+}
+
+#endif